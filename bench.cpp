@@ -0,0 +1,173 @@
+// 对比两种节点布局 (默认的带标签 union 与 ZJSON_NAN_BOXING) 和四种对象容器
+// (默认的插入序数组, ZJSON_TREE_OBJECT, ZJSON_FLAT_OBJECT, ZJSON_HASH_OBJECT).
+// 同一份源码分别编译为 bench, bench_nanbox, bench_tree_object,
+// bench_flat_object 与 bench_hash_object. 另外给出同一文档在 Tape 上,
+// 以及 PmrJson 配合单调 memory_resource 的结果
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+
+#include "zjson.hpp"
+using namespace std;
+
+// 统计堆上仍在使用的字节数. 不内联, 免得编译器把 malloc/free 与 new/delete
+// 对上号后误报
+static size_t live_bytes = 0;
+
+__attribute__((noinline)) void *operator new(size_t size) {
+    size_t *p = (size_t *)malloc(size + sizeof(size_t) * 2);
+    if (!p) throw bad_alloc();
+    *p = size;
+    live_bytes += size;
+    return p + 2;
+}
+
+__attribute__((noinline)) void operator delete(void *ptr) noexcept {
+    if (!ptr) return;
+    size_t *p = (size_t *)ptr - 2;
+    live_bytes -= *p;
+    free(p);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+
+static double ms_since(chrono::steady_clock::time_point start) {
+    auto d = chrono::steady_clock::now() - start;
+    return chrono::duration<double, milli>(d).count();
+}
+
+static void bench_objects() {
+    // 以对象为主的文档: kRecords 条记录, 每条 8 个成员
+    const size_t kRecords = 200000;
+    const char *keys[] = {"id",   "name",  "level", "host",
+                          "time", "value", "tags",  "message"};
+    string text = "[";
+    for (size_t i = 0; i < kRecords; ++i) {
+        if (i) text += ',';
+        text += "{";
+        for (size_t k = 0; k < 8; ++k) {
+            if (k) text += ',';
+            text += string("\"") + keys[k] + "\":" + to_string(i * 8 + k);
+        }
+        text += "}";
+    }
+    text += "]";
+
+#if defined(ZJSON_TREE_OBJECT)
+    const char *container = "std::map";
+#elif defined(ZJSON_FLAT_OBJECT)
+    const char *container = "flat";
+#elif defined(ZJSON_HASH_OBJECT)
+    const char *container = "hash";
+#else
+    const char *container = "ordered";
+#endif
+
+    size_t before = live_bytes;
+    auto start = chrono::steady_clock::now();
+    zjson::Json json = zjson::Json::parse(text);
+    double parse_ms = ms_since(start);
+    size_t tree_bytes = live_bytes - before;
+
+    double sum = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < kRecords; ++i) {
+        const zjson::Json &record = json[i];
+        for (const char *key : keys) sum += record[key].get<double>();
+    }
+    double lookup_ms = ms_since(start);
+
+    start = chrono::steady_clock::now();
+    json = zjson::Json();
+    double free_ms = ms_since(start);
+
+    printf("%-12s  object tree = %6.1f MB  parse = %6.1f ms  lookup = %5.1f ms"
+           "  free = %5.1f ms  (%g)\n",
+           container, tree_bytes / 1e6, parse_ms, lookup_ms, free_ms, sum);
+
+    // 同一文档解析为 PmrJson, 全部分配在单调增长的 resource 上, 整块归还
+    start = chrono::steady_clock::now();
+    {
+        std::pmr::monotonic_buffer_resource pool;
+        zjson::ResourceScope scope(&pool);
+        zjson::PmrJson pmr = zjson::PmrJson::parse(text);
+        parse_ms = ms_since(start);
+        start = chrono::steady_clock::now();
+    }
+    free_ms = ms_since(start);
+
+    printf("%-12s  parse = %6.1f ms  free = %5.1f ms\n", "pmr monotonic",
+           parse_ms, free_ms);
+}
+
+int main() {
+    // 以数字和布尔值为主的文档: kRows 行, 每行 [double, int, bool, double]
+    const size_t kRows = 1000000;
+    string text = "[";
+    for (size_t i = 0; i < kRows; ++i) {
+        if (i) text += ',';
+        text += "[" + to_string(i * 0.25) + "," + to_string(i) + "," +
+                (i % 3 ? "true" : "false") + "," + to_string(i / 7.0) + "]";
+    }
+    text += "]";
+
+#if defined(ZJSON_NAN_BOXING)
+    const char *layout = "nan-boxing";
+#else
+    const char *layout = "tagged union";
+#endif
+
+    size_t before = live_bytes;
+    auto start = chrono::steady_clock::now();
+    zjson::Json json = zjson::Json::parse(text);
+    double parse_ms = ms_since(start);
+    size_t tree_bytes = live_bytes - before;
+
+    double sum = 0;
+    size_t trues = 0;
+    start = chrono::steady_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (size_t i = 0; i < kRows; ++i) {
+            const zjson::Json &row = json[i];
+            sum += row[0].get<double>() + row[1].get<double>() +
+                   row[3].get<double>();
+            trues += row[2].get<bool>();
+        }
+    }
+    double walk_ms = ms_since(start) / 10;
+
+    printf("%-12s  sizeof(Json) = %2zu  tree = %6.1f MB  parse = %6.1f ms  "
+           "traverse = %5.1f ms  (%g, %zu)\n",
+           layout, sizeof(zjson::Json), tree_bytes / 1e6, parse_ms, walk_ms,
+           sum, trues);
+
+    // 同一文档的扁平 tape 表示
+    zjson::Tape tape;
+    before = live_bytes;
+    start = chrono::steady_clock::now();
+    tape.parse(text);
+    parse_ms = ms_since(start);
+    size_t tape_bytes = live_bytes - before;
+
+    sum = 0;
+    trues = 0;
+    start = chrono::steady_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (zjson::TapeRef row : tape.root()) {
+            sum += row[0].get<double>() + row[1].get<double>() +
+                   row[3].get<double>();
+            trues += row[2].get<bool>();
+        }
+    }
+    walk_ms = ms_since(start) / 10;
+
+    printf("%-12s  tape = %6.1f MB  parse = %6.1f ms  traverse = %5.1f ms  "
+           "(%g, %zu)\n",
+           "tape", tape_bytes / 1e6, parse_ms, walk_ms, sum, trues);
+
+    bench_objects();
+    return 0;
+}
@@ -1,12 +1,48 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "zjson.hpp"
 using namespace std;
 
-int main() {
+static int test_count = 0;
+static int test_pass = 0;
+static int main_ret = 0;
+
+#define EXPECT_EQ_BASE(equality, expect, actual)                          \
+    do {                                                                  \
+        ++test_count;                                                     \
+        if (equality) {                                                   \
+            ++test_pass;                                                  \
+        } else {                                                          \
+            cerr << __FILE__ << ":" << __LINE__ << ": expect: ["          \
+                 << (expect) << "] actual: [" << (actual) << "]" << endl; \
+            main_ret = 1;                                                 \
+        }                                                                 \
+    } while (0)
+
+#define EXPECT_EQ(expect, actual) \
+    EXPECT_EQ_BASE((expect) == (actual), expect, actual)
+#define EXPECT_TRUE(actual) EXPECT_EQ_BASE((actual), "true", "false")
+#define EXPECT_FALSE(actual) EXPECT_EQ_BASE(!(actual), "false", "true")
+#define EXPECT_EQ_RET(expect, actual) \
+    EXPECT_EQ(string(zjson::retName(expect)), string(zjson::retName(actual)))
+
+static void tutorial() {
     zjson::Json json;
 
     json["x"] = 123;
@@ -26,6 +62,1463 @@ int main() {
     auto x = json["y"].get<string>();
 
     cout << x << endl;
+}
+
+// depth 层交替嵌套的数组和对象, 最内层为 1
+static string nested(size_t depth) {
+    string text;
+    for (size_t i = 0; i < depth; ++i) text += i % 2 ? "{\"k\":" : "[";
+    text += "1";
+    for (size_t i = depth; i-- > 0;) text += i % 2 ? "}" : "]";
+    return text;
+}
+
+// 解析, dump, 拷贝和析构都不随嵌套层数占用调用栈
+static void test_deep_nesting() {
+    const size_t depth = 1000000;
+    string text = nested(depth);
+    {
+        zjson::Json json = zjson::Json::parse(text, zjson::Engine::kOnePass,
+                                              depth);
+        zjson::Json copy = json;
+        EXPECT_TRUE(json.dump() == text);
+        json = zjson::Json();
+        EXPECT_TRUE(copy.dump() == text);
+    }
+
+    zjson::Document doc;
+    doc.parse(text, zjson::Engine::kOnePass, depth);
+    zjson::Json copy = doc.root();
+    EXPECT_TRUE(copy.dump() == text);
+
+    zjson::ParseResult result = zjson::Json().tryParse(text);
+    EXPECT_EQ_RET(zjson::Ret::kParseDepthExceeded, result.ret);
+}
+
+// 长字符串不论有无转义都直接写到目的处, 结果与逐段解码一致
+static void test_parse_string() {
+    const char *cases[][2] = {
+        {"\"\"", ""},
+        {"\"short\\n\"", "short\n"},
+        {"\"longer than inline, plain\"", "longer than inline, plain"},
+        {"\"\\u00e9tude \\\"quoted\\\" \\uD834\\uDD1E\"",
+         "\xC3\xA9tude \"quoted\" \xF0\x9D\x84\x9E"},
+        {"\"\\u0041\\u0042\\u0043\"", "ABC"},
+    };
+    for (auto &c : cases) {
+        zjson::Json json = zjson::Json::parse(c[0]);
+        EXPECT_EQ(string(c[1]), json.get<string>());
+        zjson::PmrJson pmr = zjson::PmrJson::parse(c[0]);
+        EXPECT_EQ(string(c[1]), string(pmr.get<string_view>()));
+        zjson::Document doc;
+        doc.parse(c[0]);
+        EXPECT_EQ(string(c[1]), string(doc.root().get<string_view>()));
+        zjson::Json key = zjson::Json::parse(string("{") + c[0] + ":1}");
+        EXPECT_TRUE(key.contains(c[1]));
+    }
+
+    string escaped = "[\"" + string(5000, 'a') + "\\t\",\"" +
+                     string(40, 'b') + "\\n\",\"c\\nd\"]";
+    zjson::Json json = zjson::Json::parse(escaped);
+    EXPECT_EQ(string(5000, 'a') + "\t", json[0].get<string>());
+    EXPECT_EQ(string(40, 'b') + "\n", json[1].get<string>());
+    EXPECT_EQ(string("c\nd"), json[2].get<string>());
+
+    struct {
+        zjson::Ret ret;
+        const char *text;
+    } errors[] = {
+        {zjson::Ret::kParseMissQuotationMark, "\"unterminated long string"},
+        {zjson::Ret::kParseInvalidStringEscape, "\"long string, bad \\x\""},
+        {zjson::Ret::kParseInvalidStringChar, "\"long string, ctrl \x01\""},
+        {zjson::Ret::kParseInvalidUnicodeHex, "\"long string, hex \\u12\""},
+    };
+    for (auto &e : errors) {
+        zjson::Json value;
+        EXPECT_EQ_RET(e.ret, value.tryParse(e.text).ret);
+    }
+}
+
+// 非 ASCII 字符和控制字符按 \uXXXX 输出, 基本平面之外的写成代理对;
+// 末尾截断的多字节序列只用字符串之内的字节
+static void test_dump_string() {
+    const char *cases[][2] = {
+        {"\x01\x1F", "\"\\u0001\\u001F\""},
+        {"\xC3\xA9t\xC3\xA9", "\"\\u00E9t\\u00E9\""},
+        {"\xE4\xB8\xAD\xE6\x96\x87", "\"\\u4E2D\\u6587\""},
+        {"\xF0\x9F\x98\x80", "\"\\uD83D\\uDE00\""},
+        {"\xF0\xA0\x80\x80", "\"\\uD840\\uDC00\""},
+        {"\xF4\x8F\xBF\xBF", "\"\\uDBFF\\uDFFF\""},
+    };
+    for (auto &c : cases) {
+        zjson::Json json(c[0]);
+        EXPECT_EQ(string(c[1]), json.dump());
+        EXPECT_EQ(string(c[0]), zjson::Json::parse(json.dump()).get<string>());
+    }
+
+    string text = "ab\xE4\xB8\xAD" "cd";
+    zjson::Json cut(string_view(text).substr(0, 4));
+    EXPECT_EQ(string("\"ab\\u0138\""), cut.dump());
+}
+
+// 解析只看 std::string_view 的范围: 片段之后的字节 (缓冲区里没有 '\0')
+// 若被读到就会改变结果
+static void test_parse_slice() {
+    struct {
+        const char *buffer;
+        size_t size;
+        const char *expect;  // 片段的 dump, 或错误名
+    } cases[] = {
+        {"12345", 2, "12"},
+        {"-1.5e3", 4, "-1.5"},
+        {"[1,2]]", 5, "[1,2]"},
+        {"{\"a\":1}}", 7, "{\"a\":1}"},
+        {"\"ab\"c", 4, "\"ab\""},
+        {"nullx", 4, "null"},
+        {"[true] x", 7, "[true]"},
+        {"true", 3, "invalid value"},
+        {"\"abc\"", 4, "miss quotation mark"},
+        {"\"\\n\"", 2, "invalid string escape"},
+        {"[1]", 2, "miss comma or square bracket"},
+        {"{\"a\":1}", 6, "miss comma or curly bracket"},
+        {"1e5", 2, "invalid value"},
+        {"  1", 2, "expect value"},
+    };
+    const zjson::Engine engines[] = {zjson::Engine::kOnePass,
+                                     zjson::Engine::kTwoStage};
+    for (zjson::Engine engine : engines) {
+        for (auto &c : cases) {
+            vector<char> buffer(c.buffer, c.buffer + strlen(c.buffer));
+            string_view slice(buffer.data(), c.size);
+            zjson::Json json;
+            zjson::ParseResult result = json.tryParse(slice, engine);
+            string outcome =
+                result ? json.dump() : string(zjson::retName(result.ret));
+            EXPECT_EQ(string(c.expect), outcome);
+            if (result) {
+                zjson::Json parsed = zjson::Json::parse(slice, engine);
+                EXPECT_EQ(outcome, parsed.dump());
+            } else {
+                EXPECT_TRUE(result.offset <= c.size);
+            }
+        }
+    }
+}
+
+// 容器迭代器只读暴露键, 改键会破坏有序/哈希容器的查找结构
+static void test_object_iterator() {
+    using Object = zjson::Json::Object;
+    using KeyRef = decltype((*declval<Object &>().begin()).first);
+    static_assert(!is_assignable<KeyRef, zjson::Key>::value,
+                  "object keys must be read-only through iterators");
+
+    zjson::Json json = zjson::Json::parse(R"({"a":1,"b":2,"c":3})");
+    for (auto &&[key, value] : json.getRef<Object>()) {
+        value = string_view(key);
+    }
+    EXPECT_EQ(string("a"), json["a"].get<string>());
+    EXPECT_EQ(string("c"), json["c"].get<string>());
+    auto it = json.getRef<Object>().find("b");
+    EXPECT_EQ(string("b"), string(it->first));
+    EXPECT_EQ(string("b"), it->second.get<string>());
+}
+
+// 删除成员后索引随即更新, 之后的查找 (包括 const 查找) 不再修改对象
+// Json 自身的迭代器和 items(): 数组与对象, 键与值, const 与非 const,
+// 空容器与标量, 以及经迭代器写入不影响之前的副本
+static void test_json_iterator() {
+    using zjson::Json;
+    const Json array = Json::parse(R"([1,"two",[3]])");
+    string seen;
+    for (const Json &item : array) seen += item.dump() + ";";
+    EXPECT_EQ(string(R"(1;"two";[3];)"), seen);
+    EXPECT_TRUE(array.begin().key().empty());
+    EXPECT_EQ(3, std::distance(array.begin(), array.end()));
+
+    Json object = Json::parse(R"({"a":1,"b":[2],"c":{"d":3}})");
+    string keys;
+    int sum = 0;
+    const Json &cobject = object;
+    for (auto it = cobject.begin(); it != cobject.end(); ++it) {
+        keys += string(it.key());
+        if (it->isNumber()) sum += it->get<int>();
+    }
+    EXPECT_EQ(3u, keys.size());
+    EXPECT_TRUE(keys.find('a') != string::npos);
+    EXPECT_EQ(1, sum);
+    string members;
+    for (auto [key, value] : cobject.items()) {
+        members += string(key) + "=" + value.dump() + ";";
+    }
+    EXPECT_EQ(3, std::count(members.begin(), members.end(), ';'));
+    EXPECT_TRUE(members.find(R"(c={"d":3};)") != string::npos);
+
+    // 非 const 的遍历可以改写元素; 之前的副本不受影响
+    Json copy = object;
+    for (auto [key, value] : object.items()) value = key;
+    EXPECT_EQ(string("b"), object["b"].get<string>());
+    EXPECT_EQ(2, std::as_const(copy)["b"][0].get<int>());
+    Json numbers = Json::parse("[1,2,3]");
+    Json before = numbers;
+    for (Json &item : numbers) item = item.get<int>() * 10;
+    auto it = numbers.begin();
+    Json after = numbers;
+    *it = 0;
+    EXPECT_EQ(string("[0,20,30]"), numbers.dump());
+    EXPECT_EQ(string("[1,2,3]"), before.dump());
+    EXPECT_EQ(string("[10,20,30]"), after.dump());
+
+    Json empty_array = Json::parse("[]"), empty_object = Json::parse("{}");
+    EXPECT_TRUE(empty_array.begin() == empty_array.end());
+    EXPECT_TRUE(empty_object.begin() == empty_object.end());
+    EXPECT_TRUE(empty_object.items().begin() == empty_object.items().end());
+
+    // 标量不能遍历, 数组没有 items()
+    int errors = 0;
+    auto expect_error = [&](auto access) {
+        try {
+            access();
+        } catch (const runtime_error &) {
+            ++errors;
+        }
+    };
+    Json scalar(1);
+    expect_error([&] { scalar.begin(); });
+    expect_error([&] { std::as_const(scalar).end(); });
+    expect_error([&] { Json().begin(); });
+    expect_error([&] { numbers.items(); });
+    expect_error([&] { std::as_const(numbers).items(); });
+    EXPECT_EQ(5, errors);
+}
+
+static void test_object_erase() {
+    string text = "{";
+    for (int i = 0; i < 40; ++i) {
+        text += "\"k" + to_string(i) + "\":" + to_string(i) + ",";
+    }
+    text += "\"k0\":-1}";
+    zjson::Json json = zjson::Json::parse(text);
+    EXPECT_EQ(40u, json.size());
+    EXPECT_EQ(0, json["k0"].get<int>());
+
+    auto &object = json.getRef<zjson::Json::Object>();
+    for (int i = 0; i < 40; i += 2) object.erase("k" + to_string(i));
+    const zjson::Json &view = json;
+    EXPECT_EQ(20u, view.size());
+    for (int i = 0; i < 40; ++i) {
+        EXPECT_EQ(i % 2 != 0, view.contains("k" + to_string(i)));
+    }
+    EXPECT_EQ(39, view["k39"].get<int>());
+
+    json["k0"] = 100;
+    for (int i = 40; i < 60; ++i) json["k" + to_string(i)] = i;
+    EXPECT_EQ(41u, view.size());
+    EXPECT_EQ(100, view["k0"].get<int>());
+    EXPECT_EQ(59, view["k59"].get<int>());
+    EXPECT_FALSE(view.contains("k2"));
+
+    // 依次删去首、尾、中间的成员, 每步之后其余的键都要找得到;
+    // 默认的对象容器还要保持插入顺序
+    zjson::Json big = zjson::Json::parse("{}");
+    vector<string> keys;
+    for (int i = 0; i < 300; ++i) {
+        keys.push_back("m" + to_string(i * 7));
+        big[keys.back()] = i * 7;
+    }
+    auto &members = big.getRef<zjson::Json::Object>();
+    for (size_t step = 0; keys.size() > 10; ++step) {
+        size_t pos = step % 3 == 0   ? 0
+                     : step % 3 == 1 ? keys.size() - 1
+                                     : keys.size() / 2;
+        EXPECT_EQ(1u, members.erase(keys[pos]));
+        EXPECT_EQ(0u, members.erase(keys[pos]));
+        keys.erase(keys.begin() + long(pos));
+        size_t found = 0;
+        for (const string &key : keys) {
+            auto it = members.find(key);
+            found += it != members.end() &&
+                     string_view(it->first) == key &&
+                     "m" + to_string(it->second.get<int>()) == key;
+        }
+        EXPECT_EQ(keys.size(), found);
+    }
+    vector<string> order;
+    for (const auto &item : members) order.emplace_back(item.first);
+#if !defined(ZJSON_TREE_OBJECT) && !defined(ZJSON_FLAT_OBJECT) && \
+    !defined(ZJSON_HASH_OBJECT)
+    EXPECT_TRUE(keys == order);
+#endif
+    std::sort(order.begin(), order.end());
+    std::sort(keys.begin(), keys.end());
+    EXPECT_TRUE(keys == order);
+    big["m7"] = -7;
+    EXPECT_EQ(-7, std::as_const(big)["m7"].get<int>());
+    EXPECT_EQ(keys.size() + 1, big.size());
+}
+
+// 拷贝共享载荷, 但交出过可变引用或迭代器的容器在拷贝时复制一份,
+// 经旧引用的修改不会影响副本
+static void test_copy_independence() {
+    zjson::Json a = zjson::Json::parse(R"({"x":{"y":1},"v":[1,2]})");
+    zjson::Json &x = a["x"];
+    zjson::Json c = a;
+    x["z"] = 5;
+    EXPECT_TRUE(a["x"].contains("z"));
+    EXPECT_FALSE(c["x"].contains("z"));
+
+    zjson::Json *y = a["x"].find("y");
+    zjson::Json d = a;
+    *y = 2;
+    EXPECT_EQ(2, a["x"]["y"].get<int>());
+    EXPECT_EQ(1, d["x"]["y"].get<int>());
+
+    auto &v = a["v"].getRef<zjson::Json::Array>();
+    zjson::Json e = a;
+    v.push_back(zjson::Json(3));
+    EXPECT_EQ(3u, a["v"].size());
+    EXPECT_EQ(2u, e["v"].size());
+
+    zjson::Json arr = zjson::Json::parse("[1,2,3]");
+    auto it = arr.begin();
+    zjson::Json f = arr;
+    *it = 10;
+    EXPECT_EQ(10, arr[0].get<int>());
+    EXPECT_EQ(1, f[0].get<int>());
+
+    // 没有交出过引用的副本之间仍然互不影响
+    zjson::Json g = zjson::Json::parse(R"({"k":[1]})");
+    zjson::Json h = g;
+    h["k"] = 2;
+    EXPECT_EQ(1u, g["k"].size());
+    EXPECT_EQ(2, h["k"].get<int>());
+}
+
+// getRef/getIf 返回容器本身; take 移出载荷并把节点置为 null, 载荷仍与其他
+// 副本共享时拷贝一份; 显式的 Array/Object 构造接管整个容器
+static void test_get_ref_take() {
+    using zjson::Json;
+    static_assert(!is_convertible<Json::Array, Json>::value,
+                  "adopting a container must be explicit");
+    static_assert(!is_convertible<Json::Object, Json>::value,
+                  "adopting a container must be explicit");
+
+    Json array = Json::parse("[1,[2]]");
+    const Json &carray = array;
+    EXPECT_TRUE(&carray.getRef<Json::Array>() == carray.getIf<Json::Array>());
+    EXPECT_EQ(2u, carray.getRef<Json::Array>().size());
+    EXPECT_TRUE(carray.getIf<Json::Object>() == nullptr);
+    EXPECT_TRUE(array.getIf<Json::Object>() == nullptr);
+    EXPECT_TRUE(Json(1).getIf<Json::Array>() == nullptr);
+    EXPECT_TRUE(Json().getIf<Json::Object>() == nullptr);
+    int logic_errors = 0;
+    auto expect_logic_error = [&](auto access) {
+        try {
+            access();
+        } catch (const logic_error &) {
+            ++logic_errors;
+        }
+    };
+    expect_logic_error([&] { carray.getRef<Json::Object>(); });
+    expect_logic_error([&] { array.getRef<Json::Object>(); });
+    expect_logic_error([&] { Json("s").getRef<Json::Array>(); });
+    EXPECT_EQ(3, logic_errors);
+
+    // 独占的载荷直接移出
+    string long_text(40, 'x');
+    Json str(long_text);
+    EXPECT_EQ(long_text, std::move(str).take<string>());
+    EXPECT_TRUE(str.isNull());
+    Json number(5);
+    EXPECT_EQ(5, std::move(number).take<int>());
+    EXPECT_TRUE(number.isNull());
+    Json owned = Json::parse("[1,2,3]");
+    const Json *elements = std::as_const(owned).getRef<Json::Array>().data();
+    Json::Array taken = std::move(owned).take<Json::Array>();
+    EXPECT_TRUE(taken.data() == elements);
+    EXPECT_TRUE(owned.isNull());
+
+    // 共享的载荷只能拷贝, 另一个副本不受影响
+    Json shared = Json::parse(R"({"a":[1],"b":2})");
+    Json other = shared;
+    Json::Object members = std::move(shared).take<Json::Object>();
+    EXPECT_TRUE(shared.isNull());
+    members.erase("b");
+    EXPECT_EQ(1u, members.size());
+    EXPECT_EQ(2u, other.size());
+    EXPECT_EQ(2, other["b"].get<int>());
+    EXPECT_TRUE(&std::as_const(other).getRef<Json::Object>() != &members);
+
+    // 把子树移出, 修改后放回, 都不拷贝
+    Json doc = Json::parse(R"({"items":[1]})");
+    Json::Array items = std::move(doc["items"]).take<Json::Array>();
+    EXPECT_TRUE(doc["items"].isNull());
+    items.emplace_back(2);
+    const Json *data = items.data();
+    doc["items"] = Json(std::move(items));
+    EXPECT_EQ(string(R"({"items":[1,2]})"), doc.dump());
+    EXPECT_TRUE(std::as_const(doc)["items"].getRef<Json::Array>().data() ==
+                data);
+
+    Json::Object object;
+    object.emplace(zjson::Json::Key("k"), Json(1));
+    Json adopted(std::move(object));
+    EXPECT_EQ(string(R"({"k":1})"), adopted.dump());
+    EXPECT_EQ(string("[]"), Json(Json::Array()).dump());
+}
+
+template <template <typename, typename> class Map>
+struct MapTraits : zjson::JsonTraits {
+    template <typename J, typename A>
+    using Object = Map<J, A>;
+};
+
+// HashedKey 与不以 '\0' 结尾的 std::string_view 片段在各对象容器上的查找.
+// 大对象走 OrderedMap 的哈希索引, 小对象走线性查找
+template <typename Traits>
+static void check_key_lookup() {
+    using J = zjson::BasicJson<Traits>;
+    string text = "{";
+    for (int i = 0; i < 40; ++i) {
+        text += (i ? ",\"key" : "\"key") + to_string(i) + "\":" + to_string(i);
+    }
+    J json = J::parse(text + "}");
+    const J &cjson = json;
+    zjson::HashedKey key("key17");
+    EXPECT_EQ(17, cjson.find(key)->template get<int>());
+    EXPECT_EQ(17, json.find(key)->template get<int>());
+    EXPECT_TRUE(cjson.find(zjson::HashedKey("key40")) == nullptr);
+
+    const char slice[] = {'k', 'e', 'y', '1', '7', '9'};
+    EXPECT_EQ(17, cjson.at(string_view(slice, 5)).template get<int>());
+    EXPECT_EQ(1, cjson[string_view(slice, 4)].template get<int>());
+    EXPECT_EQ(1, cjson.find(zjson::HashedKey(string_view(slice, 4)))
+                     ->template get<int>());
+    EXPECT_TRUE(cjson.find(string_view(slice, 6)) == nullptr);
+    EXPECT_FALSE(cjson.contains(string_view(slice, 3)));
+    json[string_view(slice, 6)] = 179;
+    EXPECT_EQ(41u, json.size());
+    EXPECT_EQ(179, cjson.find("key179")->template get<int>());
+    EXPECT_EQ(17, cjson.find(string_view(slice, 5))->template get<int>());
+
+    J small = J::parse(R"({"id":1,"name":2})");
+    const J &csmall = small;
+    const char names[] = {'i', 'd', 'n', 'a', 'm', 'e'};
+    EXPECT_EQ(1, csmall.at(string_view(names, 2)).template get<int>());
+    EXPECT_EQ(2, csmall.find(string_view(names + 2, 4))->template get<int>());
+    EXPECT_EQ(2, small.find(zjson::HashedKey(string_view(names + 2, 4)))
+                     ->template get<int>());
+    EXPECT_TRUE(csmall.find(string_view(names, 3)) == nullptr);
+    EXPECT_TRUE(csmall.find(string_view(names + 2, 3)) == nullptr);
+    EXPECT_TRUE(csmall.find(zjson::HashedKey(string_view(names, 1))) ==
+                nullptr);
+}
+
+static void test_key_lookup() {
+    check_key_lookup<MapTraits<zjson::OrderedMap>>();
+    check_key_lookup<MapTraits<zjson::TreeMap>>();
+    check_key_lookup<MapTraits<zjson::FlatMap>>();
+    check_key_lookup<MapTraits<zjson::HashMap>>();
+}
+
+// 容器载荷的地址, 相同表示两个节点共享同一份
+static const void *payload(const zjson::Json &json) {
+    if (json.isArray()) return &json.getRef<zjson::Json::Array>();
+    return &json.getRef<zjson::Json::Object>();
+}
+
+// 非 const 访问后再拷贝: 这一层复制, 未经手的子容器仍然共享; 查找落空和
+// const 访问不影响共享
+static void test_copy_sharing() {
+    using zjson::Json;
+    Json a = Json::parse(R"({"x":{"y":1},"v":[1,2],"s":{"t":[3]}})");
+    const Json &ca = a;
+    Json b = a;
+    EXPECT_TRUE(payload(a) == payload(b));
+
+    EXPECT_TRUE(a.find("missing") == nullptr);
+    bool thrown = false;
+    try {
+        a.at("missing");
+    } catch (const out_of_range &) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    EXPECT_EQ(1, ca["x"]["y"].get<int>());
+    Json c = a;
+    EXPECT_TRUE(payload(a) == payload(c));
+
+    Json &x = a["x"];
+    Json d = a;
+    const Json &cd = d;
+    EXPECT_TRUE(payload(a) != payload(d));
+    EXPECT_TRUE(payload(ca["x"]) == payload(cd["x"]));
+    EXPECT_TRUE(payload(ca["s"]) == payload(cd["s"]));
+    x["z"] = 5;
+    EXPECT_TRUE(payload(ca["x"]) != payload(cd["x"]));
+    EXPECT_TRUE(payload(ca["s"]) == payload(cd["s"]));
+    EXPECT_FALSE(cd["x"].contains("z"));
+    EXPECT_FALSE(b["x"].contains("z"));
+    EXPECT_FALSE(c["x"].contains("z"));
+
+    Json *v = a.find("v");
+    Json e = a;
+    (*v)[0] = 9;
+    EXPECT_EQ(9, ca["v"][0].get<int>());
+    EXPECT_EQ(1, std::as_const(e)["v"][0].get<int>());
+    EXPECT_EQ(1, std::as_const(b)["v"][0].get<int>());
+    EXPECT_TRUE(payload(ca["s"]) == payload(std::as_const(e)["s"]));
+
+    Json arr = Json::parse("[[1],[2]]");
+    thrown = false;
+    try {
+        arr[5];
+    } catch (const out_of_range &) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    Json f = arr;
+    EXPECT_TRUE(payload(arr) == payload(f));
+
+    // 不再持有引用后换回可共享的载荷
+    a = Json(a);
+    Json g = a;
+    EXPECT_TRUE(payload(a) == payload(g));
+    EXPECT_EQ(a.dump(), g.dump());
+}
+
+// 游标按需查找, 跳过途经的值 (含字符串中的括号), 键中的转义解码后再比较
+static void test_cursor() {
+    using zjson::Cursor;
+    const char *text =
+        R"( {"user": {"name": "zhang", "id": 42, "tags": ["a", "b"],)"
+        R"( "esc\"key": 1, "k\u0065y": 2},)"
+        R"( "big": [[1, 2, {"x": "]}\""}], 3.5],)"
+        R"( "n": null, "t": true} )";
+    Cursor cursor(text);
+    EXPECT_TRUE(cursor.isObject());
+    EXPECT_EQ(42, cursor["user"]["id"].get<int>());
+    EXPECT_EQ(string("zhang"), cursor["user"]["name"].get<string>());
+    EXPECT_EQ(string("b"), cursor["user"]["tags"][1].get<string>());
+    EXPECT_EQ(1, cursor["user"]["esc\"key"].get<int>());
+    EXPECT_EQ(2, cursor["user"]["key"].get<int>());
+    EXPECT_EQ(3.5, cursor["big"][1].get<double>());
+    EXPECT_EQ(string("]}\""), cursor["big"][0][2]["x"].get<string>());
+    EXPECT_TRUE(cursor["n"].isNull());
+    EXPECT_TRUE(cursor["t"].get<bool>());
+    EXPECT_TRUE(cursor["big"].isArray());
+    EXPECT_TRUE(cursor["user"]["id"].isNumber());
+    EXPECT_TRUE(cursor["user"]["name"].isString());
+
+    zjson::Json tags = cursor["user"]["tags"].toJson();
+    EXPECT_EQ(string(R"(["a","b"])"), tags.dump());
+    EXPECT_EQ(string(R"([1,2,{"x":"]}\""}])"),
+              cursor["big"][0].toJson().dump());
+    EXPECT_EQ(2u, cursor["user"]["tags"].get<zjson::Json::Array>().size());
+
+    EXPECT_TRUE(cursor.contains("big"));
+    EXPECT_FALSE(cursor.contains("missing"));
+    EXPECT_TRUE(cursor.contain("t"));
+    EXPECT_FALSE(cursor["t"].contains("t"));
+    EXPECT_FALSE(cursor.find("missing").has_value());
+    EXPECT_FALSE(cursor.find(0).has_value());
+    EXPECT_FALSE(cursor["big"].find(2).has_value());
+    EXPECT_FALSE(cursor["big"].find("x").has_value());
+    EXPECT_EQ(3.5, cursor["big"].find(1)->get<double>());
+    EXPECT_FALSE(Cursor("[]").find(0).has_value());
+    EXPECT_FALSE(Cursor("{}").find("a").has_value());
+
+    int out_of_range_count = 0, type_errors = 0;
+    auto expect_throw = [&](auto access) {
+        try {
+            access();
+        } catch (const out_of_range &) {
+            ++out_of_range_count;
+        } catch (const runtime_error &) {
+            ++type_errors;
+        }
+    };
+    expect_throw([&] { cursor["missing"]; });
+    expect_throw([&] { cursor["big"][2]; });
+    expect_throw([&] { Cursor("[]")[0]; });
+    expect_throw([&] { cursor[0]; });
+    expect_throw([&] { cursor["big"]["x"]; });
+    expect_throw([&] { cursor["n"].get<int>(); });
+    EXPECT_EQ(3, out_of_range_count);
+    EXPECT_EQ(3, type_errors);
+
+    // 路径上的格式错误在访问时才发现
+    int parse_errors = 0;
+    auto expect_parse_error = [&](auto access) {
+        try {
+            access();
+        } catch (const out_of_range &) {
+        } catch (const runtime_error &) {
+            ++parse_errors;
+        }
+    };
+    expect_parse_error([] { Cursor(""); });
+    expect_parse_error([] { Cursor("  "); });
+    expect_parse_error([] { Cursor(R"({"a":[1,2})")["b"]; });
+    expect_parse_error([] { Cursor(R"({"a" 1})")["a"]; });
+    expect_parse_error([] { Cursor(R"({"a":"x)")["b"]; });
+    expect_parse_error([] { Cursor("[1 2]")[1]; });
+    expect_parse_error([] { Cursor(R"({"a":tru})")["a"].get<bool>(); });
+    expect_parse_error([] { Cursor("[1,]")[1]; });
+    EXPECT_EQ(8, parse_errors);
+}
+
+static string dump(const zjson::TapeRef &ref) {
+    switch (ref.getType()) {
+        case zjson::Type::kNull: return "null";
+        case zjson::Type::kBoolean: return ref.get<bool>() ? "true" : "false";
+        case zjson::Type::kNumber: return to_string(ref.get<int64_t>());
+        case zjson::Type::kString:
+            return "\"" + string(ref.get<string_view>()) + "\"";
+        case zjson::Type::kArray: {
+            string out = "[";
+            for (auto it = ref.begin(); it != ref.end(); ++it) {
+                if (out.size() > 1) out += ",";
+                out += dump(*it);
+            }
+            return out + "]";
+        }
+        default: {
+            string out = "{";
+            for (auto it = ref.begin(); it != ref.end(); ++it) {
+                if (out.size() > 1) out += ",";
+                out += "\"" + string(it.key()) + "\":" + dump(*it);
+            }
+            return out + "}";
+        }
+    }
+}
+
+// 标量的各种表示, 嵌套下标, 遍历, 以及越界和缺少键
+static void test_tape() {
+    zjson::Tape tape;
+    tape.parse(R"({"n":null,"t":true,"f":false,"i":-42,)"
+               R"("u":18446744073709551615,"d":2.5,"s":"a\u00e9\n",)"
+               R"("arr":[1,[2,[3]],{"k":"v"},[]],"obj":{"x":{"y":[7]}},)"
+               R"("empty":{}})");
+    zjson::TapeRef root = tape.root();
+    EXPECT_TRUE(root.isObject());
+    EXPECT_EQ(10u, root.size());
+    EXPECT_TRUE(root["n"].isNull());
+    EXPECT_TRUE(root["t"].get<bool>());
+    EXPECT_FALSE(root["f"].get<bool>());
+    EXPECT_TRUE(root["i"].isInteger());
+    EXPECT_EQ(-42, root["i"].get<int>());
+    EXPECT_EQ(-42.0, root["i"].get<double>());
+    EXPECT_EQ(UINT64_MAX, root["u"].get<uint64_t>());
+    EXPECT_FALSE(root["u"].tryGet<int64_t>().has_value());
+    EXPECT_FALSE(root["d"].isInteger());
+    EXPECT_EQ(2.5, root["d"].get<double>());
+    EXPECT_EQ(string("a\xc3\xa9\n"), root["s"].get<string>());
+    EXPECT_EQ(4u, root["s"].get<string_view>().size());
+
+    EXPECT_EQ(4u, root["arr"].size());
+    EXPECT_EQ(1, root["arr"][0].get<int>());
+    EXPECT_EQ(2, root["arr"][1][0].get<int>());
+    EXPECT_EQ(3, root["arr"][1][1][0].get<int>());
+    EXPECT_EQ(string("v"), root["arr"][2]["k"].get<string>());
+    EXPECT_EQ(0u, root["arr"][3].size());
+    EXPECT_EQ(7, root["obj"]["x"]["y"][0].get<int>());
+    EXPECT_EQ(0u, root["empty"].size());
+
+    string keys;
+    for (auto it = root.begin(); it != root.end(); ++it) {
+        keys += string(it.key()) + ",";
+    }
+    EXPECT_EQ(string("n,t,f,i,u,d,s,arr,obj,empty,"), keys);
+    int sum = 0, count = 0;
+    for (zjson::TapeRef item : root["arr"]) {
+        if (item.isNumber()) sum += item.get<int>();
+        ++count;
+    }
+    EXPECT_EQ(1, sum);
+    EXPECT_EQ(4, count);
+    EXPECT_TRUE(root["empty"].begin() == root["empty"].end());
+    EXPECT_TRUE(root["arr"][3].begin() == root["arr"][3].end());
+
+    int out_of_range_count = 0, type_errors = 0;
+    auto expect_throw = [&](auto access) {
+        try {
+            access();
+        } catch (const out_of_range &) {
+            ++out_of_range_count;
+        } catch (const runtime_error &) {
+            ++type_errors;
+        }
+    };
+    expect_throw([&] { root["arr"][4]; });
+    expect_throw([&] { root["arr"][3][0]; });
+    expect_throw([&] { root["missing"]; });
+    expect_throw([&] { root["empty"]["k"]; });
+    expect_throw([&] { root[0]; });
+    expect_throw([&] { root["arr"]["k"]; });
+    expect_throw([&] { root["s"].get<int>(); });
+    expect_throw([&] { root["n"].size(); });
+    EXPECT_EQ(4, out_of_range_count);
+    EXPECT_EQ(4, type_errors);
+    EXPECT_TRUE(root.contain("obj"));
+    EXPECT_FALSE(root.contain("missing"));
+
+    // 解析失败时根为 null, 重新解析复用同一个 Tape
+    zjson::ParseResult result = tape.tryParse("{\"a\":[1,2}");
+    EXPECT_EQ_RET(zjson::Ret::kParseMissCommaOrSquareBracket, result.ret);
+    EXPECT_EQ(9u, result.offset);
+    EXPECT_TRUE(tape.root().isNull());
+    tape.parse(" 5 ");
+    EXPECT_EQ(5, tape.root().get<int>());
+}
+
+// Tape 与 Json 一样只保留先出现的重复键, 其后的子树随之前移
+static void test_tape_duplicate_keys() {
+    zjson::Tape tape;
+    tape.parse(R"({"a":[1,{"b":2}],"d":true,"a":5})");
+    EXPECT_EQ(2u, tape.root().size());
+    EXPECT_EQ(string(R"({"a":[1,{"b":2}],"d":true})"), dump(tape.root()));
+
+    tape.parse(R"([{"x":1,"x":[2],"y":{"z":-3,"z":4},"w":[5]},[6]])");
+    EXPECT_EQ(string(R"([{"x":1,"y":{"z":-3},"w":[5]},[6]])"),
+              dump(tape.root()));
+    EXPECT_EQ(5, tape.root()[0]["w"][0].get<int>());
+    EXPECT_EQ(6, tape.root()[1][0].get<int>());
+
+    string text = "{", expect = "{";
+    for (int i = 0; i < 40; ++i) {
+        string member = "\"k" + to_string(i % 30) + "\":[" + to_string(i) + "]";
+        text += (i ? "," : "") + member;
+        if (i < 30) expect += (i ? "," : "") + member;
+    }
+    tape.parse(text + "}");
+    EXPECT_EQ(30u, tape.root().size());
+    EXPECT_EQ(expect + "}", dump(tape.root()));
+    EXPECT_EQ(30u, zjson::Json::parse(text + "}").size());
+}
+
+// 只有 PmrJson 的长键从 ResourceScope 的 resource 分配; 普通 Json 的键
+// 在作用域结束, resource 销毁后仍然有效
+static void test_resource_scope_keys() {
+    const char *text = R"({"a key longer than fourteen bytes":[1]})";
+    zjson::Json json;
+    size_t pmr_bytes = 0;
+    {
+        std::pmr::monotonic_buffer_resource resource;
+        zjson::ResourceScope scope(&resource);
+        json = zjson::Json::parse(text);
+
+        struct Counting : std::pmr::memory_resource {
+            size_t bytes = 0;
+            void *do_allocate(size_t n, size_t align) override {
+                bytes += n;
+                return std::pmr::new_delete_resource()->allocate(n, align);
+            }
+            void do_deallocate(void *p, size_t n, size_t align) override {
+                std::pmr::new_delete_resource()->deallocate(p, n, align);
+            }
+            bool do_is_equal(const memory_resource &other) const
+                noexcept override {
+                return this == &other;
+            }
+        } counting;
+        {
+            zjson::ResourceScope inner(&counting);
+            zjson::PmrJson pmr = zjson::PmrJson::parse("{}");
+            size_t before = counting.bytes;
+            pmr["another key longer than fourteen"] = 1;
+            pmr_bytes = counting.bytes - before;
+        }
+    }
+    EXPECT_EQ(string(text), json.dump());
+    EXPECT_TRUE(pmr_bytes >= strlen("another key longer than fourteen"));
+}
+
+// 计数的无状态分配器, 供自定义 String 使用
+static size_t counted_allocations = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        ++counted_allocations;
+        return allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, size_t n) { allocator<T>().deallocate(p, n); }
+
+    bool operator==(const CountingAllocator &) const { return true; }
+    bool operator!=(const CountingAllocator &) const { return false; }
+};
+
+struct FloatTraits : zjson::JsonTraits {
+    using Number = float;
+};
+
+struct FlatTraits : zjson::JsonTraits {
+    template <typename J, typename A>
+    using Object = zjson::FlatMap<J, A>;
+};
+
+struct CountingStringTraits : zjson::JsonTraits {
+    using String =
+        basic_string<char, char_traits<char>, CountingAllocator<char>>;
+};
+
+// 从 JsonTraits 派生, 只改写 Number, Object 或 String 的自定义策略
+static void test_custom_traits() {
+    // NaN-boxing 的布局要求 Number 为 double
+#if !defined(ZJSON_NAN_BOXING)
+    using FloatJson = zjson::BasicJson<FloatTraits>;
+    static_assert(is_same<FloatJson::Number, float>::value,
+                  "Number comes from the traits");
+    FloatJson floats = FloatJson::parse("[0.1, 2.5e3, -7, 16777217]");
+    EXPECT_EQ(0.1f, floats[0].get<float>());
+    EXPECT_EQ(2500.0f, floats[1].get<float>());
+    EXPECT_EQ(-7, floats[2].get<int>());
+    EXPECT_EQ(16777217, floats[3].get<int>());
+    FloatJson reparsed = FloatJson::parse(floats.dump());
+    EXPECT_EQ(floats.dump(), reparsed.dump());
+    EXPECT_EQ(0.1f, reparsed[0].get<float>());
+    floats[0] = 0.25f;
+    EXPECT_EQ(string("[0.25,2500,-7,16777217]"), floats.dump());
+#endif
+
+    using FlatJson = zjson::BasicJson<FlatTraits>;
+    static_assert(is_same<FlatJson::Object,
+                          zjson::FlatMap<FlatJson, FlatJson::Array::
+                                                       allocator_type>>::value,
+                  "Object comes from the traits");
+    FlatJson flat = FlatJson::parse(R"({"b":1,"a":{"c":[2]},"b":3})");
+    EXPECT_EQ(string(R"({"a":{"c":[2]},"b":1})"), flat.dump());
+    EXPECT_EQ(2, flat["a"]["c"][0].get<int>());
+    EXPECT_TRUE(flat.find(zjson::HashedKey("b")) != nullptr);
+    FlatJson flat_copy = flat;
+    flat["d"] = FlatJson(true);
+    flat.getRef<FlatJson::Object>().erase("b");
+    EXPECT_EQ(string(R"({"a":{"c":[2]},"d":true})"), flat.dump());
+    EXPECT_EQ(string(R"({"a":{"c":[2]},"b":1})"), flat_copy.dump());
+
+    using CountingJson = zjson::BasicJson<CountingStringTraits>;
+    static_assert(is_same<CountingJson::String,
+                          CountingStringTraits::String>::value,
+                  "String comes from the traits");
+    string long_text(40, 's');
+    size_t before = counted_allocations;
+    CountingJson strings = CountingJson::parse("[\"" + long_text + "\"]");
+    EXPECT_TRUE(counted_allocations > before);
+    CountingJson::String value = strings[0].get<CountingJson::String>();
+    EXPECT_EQ(long_text, string(value.data(), value.size()));
+    EXPECT_EQ(long_text, string(strings[0].get<string_view>()));
+    before = counted_allocations;
+    strings[0] = "short";
+    EXPECT_EQ(before, counted_allocations);
+    strings[0] = string_view(long_text);
+    EXPECT_TRUE(counted_allocations > before);
+    EXPECT_EQ(string("[\"" + long_text + "\"]"), strings.dump());
+}
+
+static uint64_t bits(double d) {
+    uint64_t u;
+    memcpy(&u, &d, sizeof(u));
+    return u;
+}
+
+// 数字与 C locale 下的 strtod 逐位一致: 边界值, 舍入到偶数的中间值,
+// 以及固定种子生成的随机输入
+static void test_parse_number() {
+    const char *cases[] = {
+        "0",
+        "-0",
+        "0.1",
+        "1e23",
+        "3.14159265358979323846264338327950288",
+        "8.98846567431158e307",
+        "1.7976931348623157e308",
+        "1.7976931348623158e308",
+        "2.2250738585072011e-308",
+        "2.2250738585072014e-308",
+        "4.9406564584124654e-324",
+        "2.4703282292062327e-324",
+        "2.4703282292062328e-324",
+        "6.631236846766476e-316",
+        "1e-400",
+        "7.038531e-26",
+        "9007199254740993.0",
+        "123456789012345678901234567890e-10",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+    };
+    for (const char *c : cases) {
+        EXPECT_EQ(bits(strtod(c, nullptr)),
+                  bits(zjson::Json::parse(c).get<double>()));
+    }
+
+    mt19937_64 rng(2024);
+    int mismatches = 0;
+    char buf[64];
+    for (int i = 0; i < 20000; ++i) {
+        if (i % 2) {
+            double d;
+            uint64_t u = rng();
+            memcpy(&d, &u, sizeof(d));
+            if (!isfinite(d)) continue;
+            snprintf(buf, sizeof(buf), "%.*g", int(u % 17) + 1, d);
+        } else {
+            string digits = to_string(rng() % 10000000000000000000u);
+            int exp = int(rng() % 660) - 340;
+            snprintf(buf, sizeof(buf), "%se%d", digits.c_str(), exp);
+        }
+        // strtod 溢出为 inf 时应报告数字过大
+        double expect = strtod(buf, nullptr);
+        zjson::Json json;
+        bool ok = json.tryParse(buf).ret == zjson::Ret::kParseOk;
+        bool same = isinf(expect)
+                        ? !ok
+                        : ok && bits(expect) == bits(json.get<double>());
+        if (!same) {
+            if (mismatches++ == 0) cerr << "mismatch: " << buf << endl;
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+
+    zjson::Json json;
+    EXPECT_EQ_RET(zjson::Ret::kParseNumberTooBig, json.tryParse("1e400").ret);
+    EXPECT_EQ_RET(zjson::Ret::kParseNumberTooBig, json.tryParse("-1e309").ret);
+}
+
+// 64 位范围内的整数原样保存和输出, 超出范围才按 double 解析
+static void test_parse_integer() {
+    const char *exact[] = {
+        "0",
+        "-1",
+        "9007199254740993",
+        "-9223372036854775808",
+        "9223372036854775807",
+        "9223372036854775808",
+        "18446744073709551615",
+    };
+    for (const char *c : exact) {
+        zjson::Json json = zjson::Json::parse(c);
+        EXPECT_TRUE(json.isInteger());
+        EXPECT_EQ(string(c), json.dump());
+    }
+    EXPECT_EQ(INT64_MIN,
+              zjson::Json::parse("-9223372036854775808").get<int64_t>());
+    EXPECT_EQ(UINT64_MAX,
+              zjson::Json::parse("18446744073709551615").get<uint64_t>());
+    EXPECT_EQ(string("9007199254740993"),
+              zjson::Json(int64_t(9007199254740993)).dump());
+
+    const char *inexact[] = {
+        "-0",
+        "1.0",
+        "1e2",
+        "18446744073709551616",
+        "-9223372036854775809",
+    };
+    for (const char *c : inexact) {
+        zjson::Json json = zjson::Json::parse(c);
+        EXPECT_FALSE(json.isInteger());
+        EXPECT_EQ(bits(strtod(c, nullptr)), bits(json.get<double>()));
+    }
+}
+
+// 有效数字个数, 不计符号, 小数点, 指数和首尾的 0
+static size_t significant_digits(const string &text) {
+    string digits;
+    for (char c : text.substr(0, text.find_first_of("eE"))) {
+        if (isdigit((unsigned char)c)) digits += c;
+    }
+    size_t first = digits.find_first_not_of('0');
+    if (first == string::npos) return 1;
+    return digits.find_last_not_of('0') - first + 1;
+}
+
+// double 输出总能还原出原值. Grisu2 对极少数值会多出一位, 其余都是最短的
+// 十进制形式
+static void test_dump_double() {
+    struct {
+        double value;
+        const char *text;
+    } cases[] = {
+        {0.1, "0.1"},
+        {0.30000000000000004, "0.30000000000000004"},
+        {1e300, "1e+300"},
+        {5e-324, "5e-324"},
+        {1.7976931348623157e308, "1.7976931348623157e+308"},
+        {-2.5, "-2.5"},
+        {1e21, "1e+21"},
+    };
+    for (auto &c : cases) {
+        EXPECT_EQ(string(c.text), zjson::Json(c.value).dump());
+    }
+
+    mt19937_64 rng(2025);
+    int count = 0, mismatches = 0, longer = 0;
+    char buf[64];
+    for (int i = 0; i < 20000; ++i) {
+        double d;
+        uint64_t u = rng();
+        memcpy(&d, &u, sizeof(d));
+        if (!isfinite(d)) continue;
+        ++count;
+        string text = zjson::Json(d).dump();
+        if (bits(strtod(text.c_str(), nullptr)) != bits(d)) {
+            if (mismatches++ == 0) cerr << "mismatch: " << text << endl;
+        }
+        // 能还原出 d 的 %.*g 中最少的有效数字个数
+        int precision = 1;
+        for (;; ++precision) {
+            snprintf(buf, sizeof(buf), "%.*g", precision, d);
+            if (bits(strtod(buf, nullptr)) == bits(d)) break;
+        }
+        if (significant_digits(text) > significant_digits(buf)) ++longer;
+    }
+    EXPECT_EQ(0, mismatches);
+    EXPECT_TRUE(longer * 100 < count);
+}
+
+// 各种解析方式共用的输入, 含合法与不合法的文本
+static const char *const kParseInputs[] = {
+    "null",
+    " [1, \"a\\n\", {\"k\": [true, false, null]}, -2.5e3] ",
+    "{\"a\":{\"b\":{\"c\":[]}},\"a\":0}",
+    "\"\\u4e2d\\uD834\\uDD1E\"",
+    "",
+    " ",
+    "nul",
+    "[1,]",
+    "{\"a\" 1}",
+    "{\"a\":1,}",
+    "[1 2]",
+    "\"abc",
+    "\"\\x\"",
+    "[1]x",
+    "{1:2}",
+    "[\"a\\u12\"]",
+    "01",
+    "1.",
+    "-",
+    "[",
+    "{\"a\":",
+    "\"\x01\"",
+    "[1e400]",
+    "\"\\uD800\"",
+    "[1,\n {\"k\": tru}]",
+};
+
+// 解析的结果: 成功时为 dump, 失败时为错误和位置
+template <typename Parse>
+static string parse_outcome(Parse parse) {
+    zjson::Json json;
+    zjson::ParseResult result = parse(json);
+    if (result) return json.dump();
+    return string(zjson::retName(result.ret)) + " at " +
+           to_string(result.offset);
+}
+
+// 两种引擎对同一输入给出相同的树或相同的错误位置. 生成的输入让引号和
+// 转义落在结构索引每 64 字节一块的边界两侧
+static void test_parse_engines() {
+    vector<string> inputs(begin(kParseInputs), end(kParseInputs));
+    for (size_t n = 50; n < 140; ++n) {
+        string text = "[\"" + string(n, 'a') + "\\\"\\\\\",{\"" +
+                      string(n % 7, 'k') + "\":[1,2]}]";
+        for (size_t len = 0; len <= text.size(); len += 3) {
+            inputs.push_back(text.substr(0, len));
+        }
+        inputs.push_back(text);
+    }
+    int mismatches = 0;
+    for (const string &text : inputs) {
+        auto parse = [&](zjson::Engine engine) {
+            return parse_outcome([&](zjson::Json &json) {
+                return json.tryParse(text, engine);
+            });
+        };
+        if (parse(zjson::Engine::kOnePass) !=
+            parse(zjson::Engine::kTwoStage)) {
+            if (mismatches++ == 0) cerr << "mismatch: " << text << endl;
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+    EXPECT_EQ(string("invalid value at 3"),
+              parse_outcome([](zjson::Json &json) {
+                  return json.tryParse("[1,]", zjson::Engine::kTwoStage);
+              }));
+}
+
+// 原地解析与普通解析结果一致, 字符串直接引用输入缓冲区
+static void test_parse_insitu() {
+    int mismatches = 0;
+    for (const char *text : kParseInputs) {
+        for (auto engine :
+             {zjson::Engine::kOnePass, zjson::Engine::kTwoStage}) {
+            string buffer = text;
+            string insitu = parse_outcome([&](zjson::Json &json) {
+                return json.tryParseInsitu(buffer.data(), buffer.size(),
+                                           engine);
+            });
+            string copied = parse_outcome([&](zjson::Json &json) {
+                return json.tryParse(text, engine);
+            });
+            if (insitu != copied) {
+                if (mismatches++ == 0) cerr << "mismatch: " << text << endl;
+            }
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+
+    string buffer = R"({"text":"a long string with \"escapes\" inside"})";
+    zjson::Json json = zjson::Json::parseInsitu(buffer.data(), buffer.size());
+    string_view text = json["text"].get<string_view>();
+    EXPECT_EQ(string("a long string with \"escapes\" inside"), string(text));
+    EXPECT_TRUE(text.data() >= buffer.data() &&
+                text.data() < buffer.data() + buffer.size());
+}
+
+// Document 与 Json 的解析结果一致. 同一个 Document 反复解析, 失败后根节点
+// 为 null; 拷贝出的 Json 不受之后解析的影响
+static void test_document_parse() {
+    zjson::Document doc;
+    auto outcome = [&](zjson::ParseResult result) {
+        if (result) return doc.root().dump();
+        if (!doc.root().isNull()) return string("root not null");
+        return string(zjson::retName(result.ret)) + " at " +
+               to_string(result.offset);
+    };
+    int mismatches = 0;
+    for (const char *text : kParseInputs) {
+        for (auto engine :
+             {zjson::Engine::kOnePass, zjson::Engine::kTwoStage}) {
+            string expect = parse_outcome([&](zjson::Json &json) {
+                return json.tryParse(text, engine);
+            });
+            string copied = outcome(doc.tryParse(text, engine));
+            string buffer = text;
+            string insitu = outcome(
+                doc.tryParseInsitu(buffer.data(), buffer.size(), engine));
+            if (copied != expect || insitu != expect) {
+                if (mismatches++ == 0) cerr << "mismatch: " << text << endl;
+            }
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+
+    const char *text = R"({"key":["a value longer than inline"]})";
+    doc.parse(text);
+    zjson::Json copy = doc.root();
+    doc.parse("[]");
+    EXPECT_EQ(zjson::Json::parse(text).dump(), copy.dump());
+}
+
+// tryParse 报告出错记号的字节偏移和从 1 开始的行列, 失败后节点为 null;
+// parse 抛出的 ParseError 带着同样的结果
+// 同一 Document 中相同的键共用键表中的一份, 重新解析时复用; 键表超出上限后
+// 在下次解析前清空. 拷贝出的 Json 持有自己的键, 不受之后的解析影响
+static void test_document_keys() {
+    using Object = zjson::Json::Object;
+    using Key = zjson::Json::Key;
+    auto key_of = [](const zjson::Json &json, string_view name) {
+        for (auto &&[key, value] : json.getRef<Object>()) {
+            if (string_view(key) == name) return &key;
+        }
+        return static_cast<const Key *>(nullptr);
+    };
+
+    zjson::Document doc;
+    doc.parse(R"([{"name":1,"id":2},{"id":3,"name":4,"a long key name":5}])");
+    const zjson::Json &root = doc.root();
+    const Key *name0 = key_of(root[0], "name");
+    const Key *name1 = key_of(root[1], "name");
+    const Key *id0 = key_of(root[0], "id");
+    EXPECT_TRUE(name0->isInterned());
+    EXPECT_TRUE(name0->data() == name1->data());
+    EXPECT_TRUE(*name0 == *name1);
+    EXPECT_FALSE(*name0 == *id0);
+    EXPECT_TRUE(*name0 == Key("name"));
+    EXPECT_TRUE(Key("name") == *name1);
+    EXPECT_EQ(3u, doc.keyCount());
+    EXPECT_EQ(size_t(5 + 3 + 16), doc.keyBytes());
+    EXPECT_EQ(4, root[1]["name"].get<int>());
+
+    zjson::Json copy = root[1];
+    const Key *copied = key_of(copy, "a long key name");
+    EXPECT_FALSE(copied->isInterned());
+    EXPECT_TRUE(copied->data() != key_of(root[1], "a long key name")->data());
+
+    const char *interned = name0->data();
+    doc.parse(R"({"other":[{"name":true}]})");
+    EXPECT_EQ(4u, doc.keyCount());
+    EXPECT_TRUE(key_of(doc.root()["other"][0], "name")->data() == interned);
+
+    // 不同的键超过 kMaxKeys 个: 本次解析照常, 下次解析前清空
+    string text = "{";
+    for (size_t i = 0; i <= zjson::Document::kMaxKeys; ++i) {
+        text += (i ? ",\"k" : "\"k") + to_string(i) + "\":0";
+    }
+    doc.parse(text + "}");
+    EXPECT_EQ(zjson::Document::kMaxKeys + 5, doc.keyCount());
+    EXPECT_EQ(0, doc.root()["k65536"].get<int>());
+    doc.parse(R"({"name":1})");
+    EXPECT_EQ(1u, doc.keyCount());
+
+    // 键共占的字节超过 kMaxKeyBytes 时同样清空
+    string big(zjson::Document::kMaxKeyBytes, 'k');
+    doc.parse("{\"" + big + "\":1}");
+    EXPECT_EQ(2u, doc.keyCount());
+    EXPECT_TRUE(doc.keyBytes() > zjson::Document::kMaxKeyBytes);
+    EXPECT_EQ(1, doc.root()[big].get<int>());
+    doc.parse(R"({"id":2})");
+    EXPECT_EQ(1u, doc.keyCount());
+
+    EXPECT_EQ(zjson::Json::parse(R"({"id":3,"name":4,"a long key name":5})")
+                  .dump(),
+              copy.dump());
+    EXPECT_EQ(5, copy["a long key name"].get<int>());
+    EXPECT_EQ(4, copy.find("name")->get<int>());
+}
+
+static void test_parse_position() {
+    struct {
+        const char *text;
+        zjson::Ret ret;
+        size_t offset, line, column;
+    } cases[] = {
+        {"", zjson::Ret::kParseExpectValue, 0, 1, 1},
+        {"[1,\n {\"k\": tru}]", zjson::Ret::kParseInvalidValue, 11, 2, 8},
+        {"{\n\n  \"a\" 1}", zjson::Ret::kParseMissColon, 9, 3, 7},
+        {"[1, 2\n", zjson::Ret::kParseMissCommaOrSquareBracket, 6, 2, 1},
+        {"\"ok\" x", zjson::Ret::kParseRootNotSingular, 5, 1, 6},
+    };
+    for (auto &c : cases) {
+        zjson::Json json(1);
+        zjson::ParseResult result = json.tryParse(c.text);
+        EXPECT_FALSE(result);
+        EXPECT_EQ_RET(c.ret, result.ret);
+        EXPECT_EQ(c.offset, result.offset);
+        EXPECT_EQ(c.line, result.line);
+        EXPECT_EQ(c.column, result.column);
+        EXPECT_TRUE(json.isNull());
+    }
+    EXPECT_TRUE(zjson::Json().tryParse(" [] "));
+
+    string message;
+    try {
+        zjson::Json::parse("[1,\n {\"k\": tru}]");
+    } catch (const zjson::ParseError &e) {
+        message = e.what();
+        EXPECT_EQ(11u, e.result().offset);
+    }
+    EXPECT_EQ(string("parse error: invalid value at line 2, column 8!"),
+              message);
+
+    zjson::Json json = zjson::Json::parse(R"({"n":1,"s":"x"})");
+    EXPECT_FALSE(json["s"].tryGet<int>().has_value());
+    EXPECT_EQ(1, json["n"].tryGet<int>().value_or(0));
+    EXPECT_EQ(7, json.valueOr("missing", 7));
+    EXPECT_EQ(string("x"), string(json.valueOr("s", "fallback")));
+    EXPECT_TRUE(json.find(0) == nullptr);
+}
+
+// Tape 与 Json 对同一输入给出相同的错误和位置, 失败后根为 null. 游标的错误
+// 位置相对整个输入; find, tryGet 和 tryToJson 不抛出异常
+static void test_parse_position_views() {
+    vector<string> inputs(begin(kParseInputs), end(kParseInputs));
+    inputs.push_back(nested(zjson::Json::kDefaultMaxDepth + 1));
+    int mismatches = 0;
+    zjson::Tape tape;
+    const zjson::Engine engines[] = {zjson::Engine::kOnePass,
+                                     zjson::Engine::kTwoStage};
+    for (const string &text : inputs) {
+        for (zjson::Engine engine : engines) {
+            zjson::ParseResult expect = zjson::Json().tryParse(text, engine);
+            zjson::ParseResult result = tape.tryParse(text, engine);
+            if (result.ret != expect.ret || result.offset != expect.offset ||
+                result.line != expect.line ||
+                (!result && !tape.root().isNull())) {
+                if (mismatches++ == 0) cerr << "mismatch: " << text << endl;
+            }
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+
+    string message;
+    try {
+        tape.parse("[1,\n {\"k\": tru}]");
+    } catch (const zjson::ParseError &e) {
+        message = e.what();
+    }
+    EXPECT_EQ(string("parse error: invalid value at line 2, column 8!"),
+              message);
+    EXPECT_TRUE(tape.root().isNull());
+
+    EXPECT_TRUE(tape.tryParse(R"({"a":[1,"x"]})"));
+    zjson::TapeRef root = tape.root();
+    EXPECT_FALSE(root.find("b").has_value());
+    EXPECT_FALSE(root.find(0).has_value());
+    EXPECT_FALSE(root.contains("b"));
+    EXPECT_EQ(1, root.find("a")->find(0)->tryGet<int>().value_or(0));
+    EXPECT_FALSE(root["a"].find(2).has_value());
+    EXPECT_FALSE(root["a"].find("a").has_value());
+    EXPECT_FALSE(root["a"][1].tryGet<int>().has_value());
+    EXPECT_EQ(string("x"), string(*root["a"][1].tryGet<string_view>()));
+    EXPECT_FALSE(root.tryGet<int>().has_value());
+
+    using zjson::Cursor;
+    auto cursor_error = [](auto access) {
+        try {
+            access();
+        } catch (const zjson::ParseError &e) {
+            return e.result();
+        }
+        return zjson::ParseResult();
+    };
+    struct {
+        zjson::ParseResult result;
+        zjson::Ret ret;
+        size_t offset;
+    } cases[] = {
+        {cursor_error([] { Cursor("  "); }), zjson::Ret::kParseExpectValue,
+         2},
+        {cursor_error([] { Cursor(R"({"a" 1})")["a"]; }),
+         zjson::Ret::kParseMissColon, 5},
+        {cursor_error([] { Cursor(R"({"a":1,})")["b"]; }),
+         zjson::Ret::kParseMissKey, 7},
+        {cursor_error([] { Cursor("[1 2]")[1]; }),
+         zjson::Ret::kParseMissCommaOrSquareBracket, 3},
+        {cursor_error([] { Cursor("[1,]")[1]; }),
+         zjson::Ret::kParseInvalidValue, 3},
+        {cursor_error([] { Cursor(R"({"a":"x)")["b"]; }),
+         zjson::Ret::kParseMissQuotationMark, 7},
+        {cursor_error([] { Cursor(R"({"a":[1,2})")["b"]; }),
+         zjson::Ret::kParseMissCommaOrCurlyBracket, 10},
+        {cursor_error([] { Cursor(R"({"\x":1})")["b"]; }),
+         zjson::Ret::kParseMissKey, 1},
+        {cursor_error([] { Cursor("[1,\n {\"k\": tru}]")[1]["k"].toJson(); }),
+         zjson::Ret::kParseInvalidValue, 11},
+    };
+    for (auto &c : cases) {
+        EXPECT_EQ_RET(c.ret, c.result.ret);
+        EXPECT_EQ(c.offset, c.result.offset);
+    }
+
+    EXPECT_FALSE(Cursor::tryOpen(" ").has_value());
+    EXPECT_FALSE(Cursor(R"({"a" 1})").find("a").has_value());
+    EXPECT_FALSE(Cursor("[1 2]").find(1).has_value());
+    EXPECT_EQ(1, Cursor::tryOpen("[1 2]")->find(0)->tryGet<int>().value());
+    Cursor cursor("[1,\n {\"k\": tru}]");
+    EXPECT_FALSE(cursor[1]["k"].tryGet<bool>().has_value());
+    zjson::Json json(1);
+    zjson::ParseResult result = cursor[1]["k"].tryToJson(json);
+    EXPECT_EQ(2u, result.line);
+    EXPECT_EQ(8u, result.column);
+    EXPECT_TRUE(json.isNull());
+    EXPECT_FALSE(cursor[1].tryToJson(json));
+    EXPECT_TRUE(cursor[0].tryToJson(json));
+    EXPECT_EQ(1, json.get<int>());
+}
+
+// RFC 6901 的示例, 转义, 数组下标和 "-", 以及 set/erase 的边界情况
+static void test_json_pointer() {
+    const char *text = R"({"foo":["bar","baz"],"":0,"a/b":1,"c%d":2,)"
+                       R"("e^f":3,"g|h":4,"i\\j":5,"k\"l":6," ":7,"m~n":8})";
+    zjson::Json doc = zjson::Json::parse(text);
+    using zjson::JsonPointer;
+    EXPECT_EQ(doc.dump(), JsonPointer("").get(doc).dump());
+    EXPECT_EQ(string(R"(["bar","baz"])"), JsonPointer("/foo").get(doc).dump());
+    EXPECT_EQ(string("bar"), JsonPointer("/foo/0").get(doc).get<string>());
+    const char *paths[] = {"/",     "/a~1b", "/c%d", "/e^f", "/g|h",
+                           "/i\\j", "/k\"l", "/ ",   "/m~0n"};
+    for (int i = 0; i < 9; ++i) {
+        EXPECT_EQ(i, JsonPointer(paths[i]).get(doc).get<int>());
+    }
+
+    JsonPointer pointer("/a~1b/m~0n/~01");
+    EXPECT_EQ(3u, pointer.size());
+    EXPECT_EQ(string("a/b"), string(pointer[0]));
+    EXPECT_EQ(string("~1"), string(pointer[2]));
+    EXPECT_EQ(string("/a~1b/m~0n/~01"), pointer.str());
+    EXPECT_FALSE(JsonPointer::tryParse("foo").has_value());
+    EXPECT_FALSE(JsonPointer::tryParse("/~2").has_value());
+    EXPECT_FALSE(JsonPointer::tryParse("/a~").has_value());
+    bool thrown = false;
+    try {
+        JsonPointer invalid("/~");
+    } catch (const invalid_argument &) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+
+    // 不是规范整数的下标, 越界的下标和 "-" 都找不到值
+    EXPECT_TRUE(JsonPointer("/foo/01").find(doc) == nullptr);
+    EXPECT_TRUE(JsonPointer("/foo/2").find(doc) == nullptr);
+    EXPECT_TRUE(JsonPointer("/foo/-").find(doc) == nullptr);
+    EXPECT_TRUE(JsonPointer("/foo/0/x").find(doc) == nullptr);
+
+    zjson::Json copy = doc;
+    EXPECT_TRUE(JsonPointer("/foo/-").set(doc, zjson::Json("qux")) != nullptr);
+    EXPECT_TRUE(JsonPointer("/foo/3").set(doc, zjson::Json(true)) != nullptr);
+    EXPECT_TRUE(JsonPointer("/foo/9").set(doc, zjson::Json(1)) == nullptr);
+    EXPECT_TRUE(JsonPointer("/foo/0/x").set(doc, zjson::Json(1)) == nullptr);
+    EXPECT_TRUE(JsonPointer("/new/a~1b").set(doc, zjson::Json(2)) != nullptr);
+    EXPECT_EQ(string(R"(["bar","baz","qux",true])"),
+              JsonPointer("/foo").get(doc).dump());
+    EXPECT_EQ(string(R"({"a/b":2})"), JsonPointer("/new").get(doc).dump());
+    EXPECT_EQ(zjson::Json::parse(text).dump(), copy.dump());
+
+    EXPECT_TRUE(JsonPointer("/foo/0").erase(doc));
+    EXPECT_EQ(string("baz"), JsonPointer("/foo/0").get(doc).get<string>());
+    EXPECT_FALSE(JsonPointer("/foo/-").erase(doc));
+    EXPECT_FALSE(JsonPointer("/missing/x").erase(doc));
+    EXPECT_TRUE(JsonPointer("/a~1b").erase(doc));
+    EXPECT_FALSE(doc.contains("a/b"));
+
+    zjson::Json root;
+    EXPECT_TRUE(JsonPointer("/a/b").set(root, zjson::Json(1)) != nullptr);
+    EXPECT_EQ(string(R"({"a":{"b":1}})"), root.dump());
+    EXPECT_TRUE(JsonPointer("").set(root, zjson::Json("x")) != nullptr);
+    EXPECT_EQ(string(R"("x")"), root.dump());
+    EXPECT_TRUE(JsonPointer("").erase(root));
+    EXPECT_TRUE(root.isNull());
+}
+
+int main() {
+    tutorial();
+    test_deep_nesting();
+    test_parse_string();
+    test_dump_string();
+    test_parse_slice();
+    test_object_iterator();
+    test_json_iterator();
+    test_object_erase();
+    test_key_lookup();
+    test_copy_independence();
+    test_copy_sharing();
+    test_get_ref_take();
+    test_cursor();
+    test_tape();
+    test_tape_duplicate_keys();
+    test_resource_scope_keys();
+    test_custom_traits();
+    test_parse_number();
+    test_parse_integer();
+    test_dump_double();
+    test_parse_engines();
+    test_parse_insitu();
+    test_document_parse();
+    test_document_keys();
+    test_parse_position();
+    test_parse_position_views();
+    test_json_pointer();
 
-    return 0;
-}
\ No newline at end of file
+    printf("%d/%d (%3.2f%%) passed\n", test_pass, test_count,
+           100.0 * test_pass / test_count);
+    return main_ret;
+}
@@ -3,19 +3,59 @@
 
 #include <errno.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cfloat>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory_resource>
+#include <new>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define ZJSON_X86_DISPATCH 1
+#endif
+
+#if defined(ZJSON_X86_DISPATCH) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// 以 -fno-exceptions 编译时, 原本抛出异常之处改为 abort. 这时应只用
+// tryParse, find, tryGet, getIf, valueOr 等不抛出异常的接口. 异常对象仍然
+// 求值, 以免只为它准备的参数和变量被报为未使用
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define ZJSON_EXCEPTIONS 1
+#define ZJSON_THROW(e) throw e
+#else
+#define ZJSON_EXCEPTIONS 0
+#define ZJSON_THROW(e) ((void)(e), std::abort())
+#endif
+
 namespace zjson {
 
-enum class Type { kNull, kBoolean, kNumber, kString, kArray, kObject };
+enum class Type : uint8_t {
+    kNull,
+    kBoolean,
+    kNumber,
+    kString,
+    kArray,
+    kObject
+};
 
 enum class Ret {
     kParseOk,
@@ -31,676 +71,6024 @@ enum class Ret {
     kParseMissCommaOrSquareBracket,
     kParseMissKey,
     kParseMissColon,
-    kParseMissCommaOrCurlyBracket
+    kParseMissCommaOrCurlyBracket,
+    kParseDepthExceeded
 };
 
-class Json {
-public:
-    using Boolean = bool;
-    using Number = double;
-    using String = std::string;
-    using Array = std::vector<Json>;
-    using Object = std::map<String, Json>;
+inline const char *retName(Ret ret) {
+    switch (ret) {
+        case Ret::kParseOk: return "ok";
+        case Ret::kParseInvalidValue: return "invalid value";
+        case Ret::kParseExpectValue: return "expect value";
+        case Ret::kParseRootNotSingular: return "root not singular";
+        case Ret::kParseNumberTooBig: return "number too big";
+        case Ret::kParseMissQuotationMark: return "miss quotation mark";
+        case Ret::kParseInvalidStringEscape: return "invalid string escape";
+        case Ret::kParseInvalidStringChar: return "invalid string char";
+        case Ret::kParseInvalidUnicodeHex: return "invalid unicode hex";
+        case Ret::kParseInvalidUnicodeSurrogate:
+            return "invalid unicode surrogate";
+        case Ret::kParseMissCommaOrSquareBracket:
+            return "miss comma or square bracket";
+        case Ret::kParseMissKey: return "miss key";
+        case Ret::kParseMissColon: return "miss colon";
+        case Ret::kParseMissCommaOrCurlyBracket:
+            return "miss comma or curly bracket";
+        case Ret::kParseDepthExceeded: return "depth exceeded";
+    }
+    return "unknown";
+}
 
-    union Value {
-        Boolean boolean;
-        Number number;
-        String *str;
-        Array *array;
-        Object *object;
-    };
+// 解析的结果. 失败时 offset 为出错的记号距输入开头的字节数 (在输入末尾出错时
+// 为输入的长度), line 和 column 由 offset 换算, 都从 1 开始
+struct ParseResult {
+    Ret ret = Ret::kParseOk;
+    size_t offset = 0;
+    size_t line = 0;
+    size_t column = 0;
 
-public:
-    inline static const char *kLiteralNull = "null";
-    inline static const char *kLiteralTrue = "true";
-    inline static const char *kLiteralFalse = "false";
+    explicit operator bool() const { return ret == Ret::kParseOk; }
 
-public:
-    void clear() {
-        switch (type_) {
-            case Type::kString:
-                if (value_.str) {
-                    delete value_.str;
-                    value_.str = nullptr;
-                }
-                break;
-            case Type::kArray:
-                if (value_.array) {
-                    delete value_.array;
-                    value_.array = nullptr;
-                }
-                break;
-            case Type::kObject:
-                if (value_.object) {
-                    delete value_.object;
-                    value_.object = nullptr;
-                }
-            default: break;
+    static ParseResult at(Ret ret, const char *begin, const char *end,
+                          const char *pos) {
+        if (ret == Ret::kParseOk) return {};
+        if (!pos) pos = end;
+        ParseResult result{ret, size_t(pos - begin), 1, 1};
+        for (const char *p = begin; p != pos; ++p) {
+            if (*p == '\n') {
+                ++result.line;
+                result.column = 1;
+            } else {
+                ++result.column;
+            }
         }
-        memset(&value_, 0, sizeof(value_));
-        type_ = Type::kNull;
-        stack_.clear();
+        return result;
     }
+};
 
-    void copy(const Json &other) {
-        type_ = other.type_;
-        switch (type_) {
-            case Type::kNumber: value_.number = other.value_.number; break;
-            case Type::kString:
-                value_.str = new std::string(*other.value_.str);
-                break;
-            case Type::kArray:
-                value_.array = new Array(*other.value_.array);
-                break;
-            case Type::kObject:
-                value_.object = new Object(*other.value_.object);
-                break;
-            default: break;
-        }
-    }
+// parse 失败时抛出, 带着 tryParse 会返回的结果
+class ParseError : public std::runtime_error {
+public:
+    explicit ParseError(const ParseResult &result)
+        : std::runtime_error(std::string("parse error: ") +
+                             retName(result.ret) + " at line " +
+                             std::to_string(result.line) + ", column " +
+                             std::to_string(result.column) + "!"),
+          result_(result) {}
 
-    void move(Json &other) {
-        type_ = other.type_;
-        memcpy(&value_, &other.value_, sizeof(value_));
-        memset(&other.value_, 0, sizeof(other.value_));
-    }
+    const ParseResult &result() const { return result_; }
 
-    Json() : type_(Type::kNull) { memset(&value_, 0, sizeof(value_)); }
+private:
+    ParseResult result_;
+};
 
-    Json(const Json &other) { copy(other); }
+// kOnePass: 逐字节扫描原文解析
+// kTwoStage: 先用 SIMD 建立结构索引, 再按索引建树
+enum class Engine { kOnePass, kTwoStage };
 
-    Json &operator=(const Json &other) {
-        if (this != &other) {
-            clear();
-            copy(other);
-        }
-        return *this;
+namespace detail {
+
+inline int ctz64(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int n = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        ++n;
     }
+    return n;
+#endif
+}
 
-    Json(Json &&other) noexcept { move(other); }
+inline bool is_whitespace(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
 
-    Json &operator=(Json &&other) noexcept {
-        if (this != &other) {
-            clear();
-            move(other);
-        }
-        return *this;
+inline bool is_structural_or_whitespace(char ch) {
+    switch (ch) {
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+        case '\"': return true;
+        default: return is_whitespace(ch);
+    }
+}
+
+// 返回 [p, end) 中第一个引号、反斜杠或控制字符的位置, 没有则返回 end.
+// 字符串里这三种字符之外的部分可以整段拷贝
+inline const char *scan_string(const char *p, const char *end) {
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                            _mm256_cmpeq_epi8(v, backslash)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(hit));
+        if (mask) return p + ctz64(mask);
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i quote16 = _mm_set1_epi8('\"');
+    const __m128i backslash16 = _mm_set1_epi8('\\');
+    const __m128i control16 = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote16),
+                         _mm_cmpeq_epi8(v, backslash16)),
+            _mm_cmpeq_epi8(_mm_min_epu8(v, control16), v));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(hit));
+        if (mask) return p + ctz64(mask);
+        p += 16;
+    }
+#endif
+    while (p != end) {
+        unsigned char ch = *p;
+        if (ch == '\"' || ch == '\\' || ch < 0x20) break;
+        ++p;
+    }
+    return p;
+}
+
+// 返回 [p, end) 中第一个引号或括号 []{} 的位置, 没有则返回 end. 用于跳过整个值.
+// '[' ']' 与 '{' '}' 只差 0x20 位, 置上该位后只需比较两次
+inline const char *scan_bracket(const char *p, const char *end) {
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        __m256i folded = _mm256_or_si256(v, lower);
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, open),
+                            _mm256_cmpeq_epi8(folded, close)),
+            _mm256_cmpeq_epi8(v, quote));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(hit));
+        if (mask) return p + ctz64(mask);
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i quote16 = _mm_set1_epi8('\"');
+    const __m128i lower16 = _mm_set1_epi8(0x20);
+    const __m128i open16 = _mm_set1_epi8('{');
+    const __m128i close16 = _mm_set1_epi8('}');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i folded = _mm_or_si128(v, lower16);
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open16),
+                         _mm_cmpeq_epi8(folded, close16)),
+            _mm_cmpeq_epi8(v, quote16));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(hit));
+        if (mask) return p + ctz64(mask);
+        p += 16;
+    }
+#endif
+    while (p != end) {
+        char ch = *p | 0x20;
+        if (ch == '{' || ch == '}' || *p == '\"') break;
+        ++p;
     }
+    return p;
+}
 
-    ~Json() { clear(); }
+// 一个 64 字节块中各类字符的位图, 第 i 位对应块内第 i 个字节
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t whitespace;
+    uint64_t op;  // {}[]:,
+};
 
-    Json(Number number) : type_(Type::kNumber) { value_.number = number; }
+// 第一阶段: 以 64 字节为一块求出字符串外的结构字符 {}[]:, 、字符串的起始引号
+// 以及每个标量 (数字/字面量) 的首字节, 按顺序记录其偏移. 块间只需传递三个进位
+class StructuralIndex {
+public:
+    void build(const char *text, size_t len) {
+        positions_.clear();
+        prev_escaped_ = 0;
+        prev_in_string_ = 0;
+        prev_scalar_ = 0;
+#ifdef ZJSON_X86_DISPATCH
+        static const int isa = detect_isa();
+        if (isa == kAvx2) return build_avx2(text, len);
+        if (isa == kSse42) return build_sse42(text, len);
+#endif
+        build_scalar(text, len);
+    }
 
-    Json(int number) : Json(Number(number)) {}
+    const uint32_t *begin() const { return positions_.data(); }
+    const uint32_t *end() const { return positions_.data() + count_; }
 
-    explicit Json(Boolean b) : type_(Type::kBoolean) { value_.boolean = b; }
+private:
+    static constexpr size_t kBlock = 64;
 
-    Json(const char *str) : type_(Type::kString) {
-        value_.str = new String(str);
+    // 反斜杠序列中被转义的字符 (奇数个反斜杠之后的那个字符)
+    uint64_t escaped(uint64_t backslash) {
+        const uint64_t even_bits = 0x5555555555555555ULL;
+        backslash &= ~prev_escaped_;
+        uint64_t follows_escape = backslash << 1 | prev_escaped_;
+        uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+        uint64_t even_sequences = odd_starts + backslash;
+        prev_escaped_ = even_sequences < odd_starts;
+        return (even_bits ^ (even_sequences << 1)) & follows_escape;
     }
 
-    Json(std::string_view sv) : type_(Type::kString) {
-        value_.str = new String(sv);
+    static uint64_t prefix_xor(uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
     }
 
-    Type getType() const { return type_; }
+    // quote 为未转义的引号, quote_prefix 为其前缀异或 (引号区间掩码)
+    uint64_t structurals(const BlockMasks &m, uint64_t quote,
+                         uint64_t quote_prefix) {
+        uint64_t in_string = quote_prefix ^ prev_in_string_;
+        prev_in_string_ = uint64_t(int64_t(in_string) >> 63);
+        uint64_t scalar = ~(m.op | m.whitespace | quote) & ~in_string;
+        uint64_t scalar_start = scalar & ~(scalar << 1 | prev_scalar_);
+        prev_scalar_ = scalar >> 63;
+        return (m.op & ~in_string) | (quote & in_string) | scalar_start;
+    }
 
-    Json &operator[](size_t idx) {
-        check_type(Type::kArray, "array");
-        return value_.array->at(idx);
+    void flatten(size_t offset, uint64_t bits) {
+        if (positions_.size() < count_ + kBlock) {
+            positions_.resize(positions_.size() * 2 + kBlock);
+        }
+        uint32_t *out = positions_.data() + count_;
+        while (bits) {
+            *out++ = uint32_t(offset + ctz64(bits));
+            bits &= bits - 1;
+        }
+        count_ = out - positions_.data();
     }
 
-    bool contain(const std::string key) {
-        check_type(Type::kObject, "object");
-        return value_.object->find(key) != value_.object->end();
+    // 末尾不足一块的部分补空格, 空格不会产生结构字符
+    static const char *tail_block(const char *text, size_t len, size_t offset,
+                                  char *buf) {
+        memset(buf, ' ', kBlock);
+        memcpy(buf, text + offset, len - offset);
+        return buf;
     }
 
-    Json &operator[](const std::string &key) {
-        if (type_ == Type::kNull) {
-            type_ = Type::kObject;
-            value_.object = new Object();
-        } else {
-            check_type(Type::kObject, "object");
+    static BlockMasks classify_scalar(const char *block) {
+        BlockMasks m{0, 0, 0, 0};
+        for (size_t i = 0; i < kBlock; ++i) {
+            uint64_t bit = uint64_t(1) << i;
+            switch (block[i]) {
+                case '\"': m.quote |= bit; break;
+                case '\\': m.backslash |= bit; break;
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r': m.whitespace |= bit; break;
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',': m.op |= bit; break;
+                default: break;
+            }
         }
-        return (*value_.object)[key];
+        return m;
     }
 
-    template <typename T>
-    T get() const {
-        if constexpr (std::is_same<T, Boolean>::value) {
-            check_type(Type::kBoolean, "Boolean");
-            return value_.boolean;
-        } else if constexpr (std::is_same<T, Number>::value) {
-            check_type(Type::kNumber, "Number");
-            return value_.number;
-        } else if constexpr (std::is_same<T, String>::value) {
-            check_type(Type::kString, "String");
-            return *value_.str;
-        } else if constexpr (std::is_same<T, Array>::value) {
-            check_type(Type::kArray, "Array");
-            return *value_.array;
-        } else if constexpr (std::is_same<T, Object>::value) {
-            check_type(Type::kObject, "Object");
-            return *value_.object;
+    void build_scalar(const char *text, size_t len) {
+        count_ = 0;
+        char buf[kBlock];
+        for (size_t offset = 0; offset < len; offset += kBlock) {
+            const char *block = len - offset >= kBlock
+                                    ? text + offset
+                                    : tail_block(text, len, offset, buf);
+            BlockMasks m = classify_scalar(block);
+            uint64_t quote = m.quote & ~escaped(m.backslash);
+            flatten(offset, structurals(m, quote, prefix_xor(quote)));
         }
-        throw std::runtime_error("type error");
+        positions_.resize(count_);
     }
 
-    bool isNull() const { return type_ == Type::kNull; }
-    bool isBoolean() const { return type_ == Type::kBoolean; }
-    bool isString() const { return type_ == Type::kString; }
-    bool isArray() const { return type_ == Type::kArray; }
-    bool isObject() const { return type_ == Type::kObject; }
+#ifdef ZJSON_X86_DISPATCH
+    enum { kScalar, kSse42, kAvx2 };
 
-    static Json parse(std::string_view text) {
-        Json json;
-        Ret ret = json.parse(text.data());
-        if (ret != Ret::kParseOk) {
-            throw std::runtime_error("parse error!");
-        }
-        return json;
+    static int detect_isa() {
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("pclmul")) return kScalar;
+        if (__builtin_cpu_supports("avx2")) return kAvx2;
+        if (__builtin_cpu_supports("sse4.2")) return kSse42;
+        return kScalar;
     }
 
-    std::string dump() {
-        char *str = stringify();
-        std::string res(str);
-        free(str);
-        return res;
+    // 无进位乘以全 1 即前缀异或
+    __attribute__((target("pclmul"))) static uint64_t prefix_xor_clmul(
+        uint64_t bits) {
+        __m128i all_ones = _mm_set1_epi8('\xFF');
+        __m128i v = _mm_set_epi64x(0, int64_t(bits));
+        __m128i product = _mm_clmulepi64_si128(v, all_ones, 0);
+        return uint64_t(_mm_cvtsi128_si64(product));
     }
 
-private:
-    Ret parse(const char *text) {
-        clear();
+    __attribute__((target("sse4.2"))) static uint64_t eq_sse42(
+        __m128i v[4], char ch) {
+        __m128i c = _mm_set1_epi8(ch);
+        uint64_t m0 = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v[0], c)));
+        uint64_t m1 = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v[1], c)));
+        uint64_t m2 = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v[2], c)));
+        uint64_t m3 = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v[3], c)));
+        return m0 | m1 << 16 | m2 << 32 | m3 << 48;
+    }
 
-        Ret ret = parse_text(text);
-        // assert(stack_.size() == 0);
+    __attribute__((target("sse4.2,pclmul"))) void build_sse42(
+        const char *text, size_t len) {
+        count_ = 0;
+        char buf[kBlock];
+        for (size_t offset = 0; offset < len; offset += kBlock) {
+            const char *block = len - offset >= kBlock
+                                    ? text + offset
+                                    : tail_block(text, len, offset, buf);
+            __m128i v[4];
+            for (int i = 0; i < 4; ++i) {
+                v[i] = _mm_loadu_si128((const __m128i *)(block + 16 * i));
+            }
+            BlockMasks m;
+            m.quote = eq_sse42(v, '\"');
+            m.backslash = eq_sse42(v, '\\');
+            m.whitespace = eq_sse42(v, ' ') | eq_sse42(v, '\t') |
+                           eq_sse42(v, '\n') | eq_sse42(v, '\r');
+            m.op = eq_sse42(v, '{') | eq_sse42(v, '}') | eq_sse42(v, '[') |
+                   eq_sse42(v, ']') | eq_sse42(v, ':') | eq_sse42(v, ',');
+            uint64_t quote = m.quote & ~escaped(m.backslash);
+            flatten(offset, structurals(m, quote, prefix_xor_clmul(quote)));
+        }
+        positions_.resize(count_);
+    }
 
-        if (ret != Ret::kParseOk) return ret;
+    __attribute__((target("avx2"))) static uint64_t eq_avx2(__m256i lo,
+                                                            __m256i hi,
+                                                            char ch) {
+        __m256i c = _mm256_set1_epi8(ch);
+        uint64_t m0 = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, c)));
+        uint64_t m1 = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, c)));
+        return m0 | m1 << 32;
+    }
 
-        parse_whitespace(text);
-        if (*text) {
-            clear();
-            return Ret::kParseRootNotSingular;
+    __attribute__((target("avx2,pclmul"))) void build_avx2(const char *text,
+                                                            size_t len) {
+        count_ = 0;
+        char buf[kBlock];
+        for (size_t offset = 0; offset < len; offset += kBlock) {
+            const char *block = len - offset >= kBlock
+                                    ? text + offset
+                                    : tail_block(text, len, offset, buf);
+            __m256i lo = _mm256_loadu_si256((const __m256i *)block);
+            __m256i hi = _mm256_loadu_si256((const __m256i *)(block + 32));
+            BlockMasks m;
+            m.quote = eq_avx2(lo, hi, '\"');
+            m.backslash = eq_avx2(lo, hi, '\\');
+            m.whitespace = eq_avx2(lo, hi, ' ') | eq_avx2(lo, hi, '\t') |
+                           eq_avx2(lo, hi, '\n') | eq_avx2(lo, hi, '\r');
+            m.op = eq_avx2(lo, hi, '{') | eq_avx2(lo, hi, '}') |
+                   eq_avx2(lo, hi, '[') | eq_avx2(lo, hi, ']') |
+                   eq_avx2(lo, hi, ':') | eq_avx2(lo, hi, ',');
+            uint64_t quote = m.quote & ~escaped(m.backslash);
+            flatten(offset, structurals(m, quote, prefix_xor_clmul(quote)));
         }
-
-        return ret;
+        positions_.resize(count_);
     }
+#endif
+
+    std::vector<uint32_t> positions_;
+    size_t count_ = 0;
+    uint64_t prev_escaped_ = 0;
+    uint64_t prev_in_string_ = 0;
+    uint64_t prev_scalar_ = 0;
+};
+
+// 解析器的输入端. peek() 跳过空白返回下一个记号的首字节, 没有则返回 nullptr;
+// advance() 越过单字符的结构记号; 字符串和标量从 begin_scalar() 开始解析,
+// 解析完把结束位置交给 end_scalar()
 
-    char *stringify_boolean() {
-        return value_.boolean ? str_dup(kLiteralTrue, 4)
-                              : str_dup(kLiteralFalse, 5);
+// 单趟解析: 直接在原文上逐字节前进
+struct TextSource {
+    const char *text;
+    const char *end;
+
+    const char *peek() {
+        while (text != end && is_whitespace(*text)) ++text;
+        return text == end ? nullptr : text;
     }
 
-    char *stringify() {
-        switch (type_) {
-            case Type::kNull: return str_dup(kLiteralNull, 4);
-            case Type::kBoolean: return stringify_boolean();
-            case Type::kNumber: return stringify_number();
-            case Type::kString: return stringify_string();
-            case Type::kArray: return stringify_array();
-            case Type::kObject: return stringify_object();
-            default: break;
-        }
-        return nullptr;
+    void advance() { ++text; }
+
+    const char *begin_scalar() const { return text; }
+
+    void end_scalar(const char *p) { text = p; }
+};
+
+// 第二阶段的游标. 标量之后若紧跟非空白非结构字符, 记为 junk 交给上层按语境报错
+struct Tokens {
+    const char *begin;
+    const char *end;
+    const uint32_t *next;
+    const uint32_t *last;
+    const char *junk = nullptr;
+
+    const char *peek() const {
+        if (junk) return junk;
+        return next == last ? nullptr : begin + *next;
     }
 
-    bool is_null() const { return type_ == Type::kNull; }
+    void advance() { ++next; }
 
-    bool is_bool(bool b) const { return type_ == Type::kBoolean; }
-    double get_number() const {
-        check_type(Type::kNumber, "number");
-        return value_.number;
+    const char *begin_scalar() {
+        const char *p = peek();
+        advance();
+        return p;
     }
 
-    const char *get_string() const {
-        check_type(Type::kString, "string");
-        return value_.str->data();
+    void end_scalar(const char *p) {
+        if (p != end && !is_structural_or_whitespace(*p)) junk = p;
     }
+};
 
-    size_t get_array_size() const {
-        check_type(Type::kArray, "array");
-        return value_.array->size();
+// 原地反转义的输出端: 转义序列总比解码结果长, 写位置不会越过读位置
+struct InsituWriter {
+    char *begin;
+    char *cur;
+
+    void append(const char *s, size_t n) {
+        if (cur != s) memmove(cur, s, n);
+        cur += n;
     }
 
-    Json &get_array_element(size_t idx) const {
-        check_type(Type::kArray, "array");
-        return (*value_.array)[idx];
+    void push_back(char ch) { *cur++ = ch; }
+
+    size_t size() const { return cur - begin; }
+};
+
+// ---- 十进制 -> double (Eisel-Lemire) ----
+
+// 5^q 的 128 位近似, q ∈ [-342, 308], 每项依次为高 64 位、低 64 位.
+// q < 0 时取 2^b / 5^-q 向上取整后截断到 128 位, q >= 0 时为截断值
+inline constexpr int kSmallestPowerOfTen = -342;
+inline constexpr int kLargestPowerOfTen = 308;
+inline constexpr uint64_t kPowerOfFive128[] = {
+    0xeef453d6923bd65a, 0x113faa2906a13b3f,
+    0x9558b4661b6565f8, 0x4ac7ca59a424c507,
+    0xbaaee17fa23ebf76, 0x5d79bcf00d2df649,
+    0xe95a99df8ace6f53, 0xf4d82c2c107973dc,
+    0x91d8a02bb6c10594, 0x79071b9b8a4be869,
+    0xb64ec836a47146f9, 0x9748e2826cdee284,
+    0xe3e27a444d8d98b7, 0xfd1b1b2308169b25,
+    0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7,
+    0xb208ef855c969f4f, 0xbdbd2d335e51a935,
+    0xde8b2b66b3bc4723, 0xad2c788035e61382,
+    0x8b16fb203055ac76, 0x4c3bcb5021afcc31,
+    0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d,
+    0xd953e8624b85dd78, 0xd71d6dad34a2af0d,
+    0x87d4713d6f33aa6b, 0x8672648c40e5ad68,
+    0xa9c98d8ccb009506, 0x680efdaf511f18c2,
+    0xd43bf0effdc0ba48, 0x0212bd1b2566def2,
+    0x84a57695fe98746d, 0x014bb630f7604b57,
+    0xa5ced43b7e3e9188, 0x419ea3bd35385e2d,
+    0xcf42894a5dce35ea, 0x52064cac828675b9,
+    0x818995ce7aa0e1b2, 0x7343efebd1940993,
+    0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8,
+    0xca66fa129f9b60a6, 0xd41a26e077774ef6,
+    0xfd00b897478238d0, 0x8920b098955522b4,
+    0x9e20735e8cb16382, 0x55b46e5f5d5535b0,
+    0xc5a890362fddbc62, 0xeb2189f734aa831d,
+    0xf712b443bbd52b7b, 0xa5e9ec7501d523e4,
+    0x9a6bb0aa55653b2d, 0x47b233c92125366e,
+    0xc1069cd4eabe89f8, 0x999ec0bb696e840a,
+    0xf148440a256e2c76, 0xc00670ea43ca250d,
+    0x96cd2a865764dbca, 0x380406926a5e5728,
+    0xbc807527ed3e12bc, 0xc605083704f5ecf2,
+    0xeba09271e88d976b, 0xf7864a44c633682e,
+    0x93445b8731587ea3, 0x7ab3ee6afbe0211d,
+    0xb8157268fdae9e4c, 0x5960ea05bad82964,
+    0xe61acf033d1a45df, 0x6fb92487298e33bd,
+    0x8fd0c16206306bab, 0xa5d3b6d479f8e056,
+    0xb3c4f1ba87bc8696, 0x8f48a4899877186c,
+    0xe0b62e2929aba83c, 0x331acdabfe94de87,
+    0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14,
+    0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9,
+    0xdb71e91432b1a24a, 0xc9e82cd9f69d6150,
+    0x892731ac9faf056e, 0xbe311c083a225cd2,
+    0xab70fe17c79ac6ca, 0x6dbd630a48aaf406,
+    0xd64d3d9db981787d, 0x092cbbccdad5b108,
+    0x85f0468293f0eb4e, 0x25bbf56008c58ea5,
+    0xa76c582338ed2621, 0xaf2af2b80af6f24e,
+    0xd1476e2c07286faa, 0x1af5af660db4aee1,
+    0x82cca4db847945ca, 0x50d98d9fc890ed4d,
+    0xa37fce126597973c, 0xe50ff107bab528a0,
+    0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8,
+    0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a,
+    0x9faacf3df73609b1, 0x77b191618c54e9ac,
+    0xc795830d75038c1d, 0xd59df5b9ef6a2417,
+    0xf97ae3d0d2446f25, 0x4b0573286b44ad1d,
+    0x9becce62836ac577, 0x4ee367f9430aec32,
+    0xc2e801fb244576d5, 0x229c41f793cda73f,
+    0xf3a20279ed56d48a, 0x6b43527578c1110f,
+    0x9845418c345644d6, 0x830a13896b78aaa9,
+    0xbe5691ef416bd60c, 0x23cc986bc656d553,
+    0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8,
+    0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9,
+    0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53,
+    0xe858ad248f5c22c9, 0xd1b3400f8f9cff68,
+    0x91376c36d99995be, 0x23100809b9c21fa1,
+    0xb58547448ffffb2d, 0xabd40a0c2832a78a,
+    0xe2e69915b3fff9f9, 0x16c90c8f323f516c,
+    0x8dd01fad907ffc3b, 0xae3da7d97f6792e3,
+    0xb1442798f49ffb4a, 0x99cd11cfdf41779c,
+    0xdd95317f31c7fa1d, 0x40405643d711d583,
+    0x8a7d3eef7f1cfc52, 0x482835ea666b2572,
+    0xad1c8eab5ee43b66, 0xda3243650005eecf,
+    0xd863b256369d4a40, 0x90bed43e40076a82,
+    0x873e4f75e2224e68, 0x5a7744a6e804a291,
+    0xa90de3535aaae202, 0x711515d0a205cb36,
+    0xd3515c2831559a83, 0x0d5a5b44ca873e03,
+    0x8412d9991ed58091, 0xe858790afe9486c2,
+    0xa5178fff668ae0b6, 0x626e974dbe39a872,
+    0xce5d73ff402d98e3, 0xfb0a3d212dc8128f,
+    0x80fa687f881c7f8e, 0x7ce66634bc9d0b99,
+    0xa139029f6a239f72, 0x1c1fffc1ebc44e80,
+    0xc987434744ac874e, 0xa327ffb266b56220,
+    0xfbe9141915d7a922, 0x4bf1ff9f0062baa8,
+    0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9,
+    0xc4ce17b399107c22, 0xcb550fb4384d21d3,
+    0xf6019da07f549b2b, 0x7e2a53a146606a48,
+    0x99c102844f94e0fb, 0x2eda7444cbfc426d,
+    0xc0314325637a1939, 0xfa911155fefb5308,
+    0xf03d93eebc589f88, 0x793555ab7eba27ca,
+    0x96267c7535b763b5, 0x4bc1558b2f3458de,
+    0xbbb01b9283253ca2, 0x9eb1aaedfb016f16,
+    0xea9c227723ee8bcb, 0x465e15a979c1cadc,
+    0x92a1958a7675175f, 0x0bfacd89ec191ec9,
+    0xb749faed14125d36, 0xcef980ec671f667b,
+    0xe51c79a85916f484, 0x82b7e12780e7401a,
+    0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810,
+    0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15,
+    0xdfbdcece67006ac9, 0x67a791e093e1d49a,
+    0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0,
+    0xaecc49914078536d, 0x58fae9f773886e18,
+    0xda7f5bf590966848, 0xaf39a475506a899e,
+    0x888f99797a5e012d, 0x6d8406c952429603,
+    0xaab37fd7d8f58178, 0xc8e5087ba6d33b83,
+    0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64,
+    0x855c3be0a17fcd26, 0x5cf2eea09a55067f,
+    0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e,
+    0xd0601d8efc57b08b, 0xf13b94daf124da26,
+    0x823c12795db6ce57, 0x76c53d08d6b70858,
+    0xa2cb1717b52481ed, 0x54768c4b0c64ca6e,
+    0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09,
+    0xfe5d54150b090b02, 0xd3f93b35435d7c4c,
+    0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf,
+    0xc6b8e9b0709f109a, 0x359ab6419ca1091b,
+    0xf867241c8cc6d4c0, 0xc30163d203c94b62,
+    0x9b407691d7fc44f8, 0x79e0de63425dcf1d,
+    0xc21094364dfb5636, 0x985915fc12f542e4,
+    0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d,
+    0x979cf3ca6cec5b5a, 0xa705992ceecf9c42,
+    0xbd8430bd08277231, 0x50c6ff782a838353,
+    0xece53cec4a314ebd, 0xa4f8bf5635246428,
+    0x940f4613ae5ed136, 0x871b7795e136be99,
+    0xb913179899f68584, 0x28e2557b59846e3f,
+    0xe757dd7ec07426e5, 0x331aeada2fe589cf,
+    0x9096ea6f3848984f, 0x3ff0d2c85def7621,
+    0xb4bca50b065abe63, 0x0fed077a756b53a9,
+    0xe1ebce4dc7f16dfb, 0xd3e8495912c62894,
+    0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c,
+    0xb080392cc4349dec, 0xbd8d794d96aacfb3,
+    0xdca04777f541c567, 0xecf0d7a0fc5583a0,
+    0x89e42caaf9491b60, 0xf41686c49db57244,
+    0xac5d37d5b79b6239, 0x311c2875c522ced5,
+    0xd77485cb25823ac7, 0x7d633293366b828b,
+    0x86a8d39ef77164bc, 0xae5dff9c02033197,
+    0xa8530886b54dbdeb, 0xd9f57f830283fdfc,
+    0xd267caa862a12d66, 0xd072df63c324fd7b,
+    0x8380dea93da4bc60, 0x4247cb9e59f71e6d,
+    0xa46116538d0deb78, 0x52d9be85f074e608,
+    0xcd795be870516656, 0x67902e276c921f8b,
+    0x806bd9714632dff6, 0x00ba1cd8a3db53b6,
+    0xa086cfcd97bf97f3, 0x80e8a40eccd228a4,
+    0xc8a883c0fdaf7df0, 0x6122cd128006b2cd,
+    0xfad2a4b13d1b5d6c, 0x796b805720085f81,
+    0x9cc3a6eec6311a63, 0xcbe3303674053bb0,
+    0xc3f490aa77bd60fc, 0xbedbfc4411068a9c,
+    0xf4f1b4d515acb93b, 0xee92fb5515482d44,
+    0x991711052d8bf3c5, 0x751bdd152d4d1c4a,
+    0xbf5cd54678eef0b6, 0xd262d45a78a0635d,
+    0xef340a98172aace4, 0x86fb897116c87c34,
+    0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0,
+    0xbae0a846d2195712, 0x8974836059cca109,
+    0xe998d258869facd7, 0x2bd1a438703fc94b,
+    0x91ff83775423cc06, 0x7b6306a34627ddcf,
+    0xb67f6455292cbf08, 0x1a3bc84c17b1d542,
+    0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93,
+    0x8e938662882af53e, 0x547eb47b7282ee9c,
+    0xb23867fb2a35b28d, 0xe99e619a4f23aa43,
+    0xdec681f9f4c31f31, 0x6405fa00e2ec94d4,
+    0x8b3c113c38f9f37e, 0xde83bc408dd3dd04,
+    0xae0b158b4738705e, 0x9624ab50b148d445,
+    0xd98ddaee19068c76, 0x3badd624dd9b0957,
+    0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6,
+    0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c,
+    0xd47487cc8470652b, 0x7647c3200069671f,
+    0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073,
+    0xa5fb0a17c777cf09, 0xf468107100525890,
+    0xcf79cc9db955c2cc, 0x7182148d4066eeb4,
+    0x81ac1fe293d599bf, 0xc6f14cd848405530,
+    0xa21727db38cb002f, 0xb8ada00e5a506a7c,
+    0xca9cf1d206fdc03b, 0xa6d90811f0e4851c,
+    0xfd442e4688bd304a, 0x908f4a166d1da663,
+    0x9e4a9cec15763e2e, 0x9a598e4e043287fe,
+    0xc5dd44271ad3cdba, 0x40eff1e1853f29fd,
+    0xf7549530e188c128, 0xd12bee59e68ef47c,
+    0x9a94dd3e8cf578b9, 0x82bb74f8301958ce,
+    0xc13a148e3032d6e7, 0xe36a52363c1faf01,
+    0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1,
+    0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9,
+    0xbcb2b812db11a5de, 0x7415d448f6b6f0e7,
+    0xebdf661791d60f56, 0x111b495b3464ad21,
+    0x936b9fcebb25c995, 0xcab10dd900beec34,
+    0xb84687c269ef3bfb, 0x3d5d514f40eea742,
+    0xe65829b3046b0afa, 0x0cb4a5a3112a5112,
+    0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab,
+    0xb3f4e093db73a093, 0x59ed216765690f56,
+    0xe0f218b8d25088b8, 0x306869c13ec3532c,
+    0x8c974f7383725573, 0x1e414218c73a13fb,
+    0xafbd2350644eeacf, 0xe5d1929ef90898fa,
+    0xdbac6c247d62a583, 0xdf45f746b74abf39,
+    0x894bc396ce5da772, 0x6b8bba8c328eb783,
+    0xab9eb47c81f5114f, 0x066ea92f3f326564,
+    0xd686619ba27255a2, 0xc80a537b0efefebd,
+    0x8613fd0145877585, 0xbd06742ce95f5f36,
+    0xa798fc4196e952e7, 0x2c48113823b73704,
+    0xd17f3b51fca3a7a0, 0xf75a15862ca504c5,
+    0x82ef85133de648c4, 0x9a984d73dbe722fb,
+    0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba,
+    0xcc963fee10b7d1b3, 0x318df905079926a8,
+    0xffbbcfe994e5c61f, 0xfdf17746497f7052,
+    0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633,
+    0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0,
+    0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0,
+    0x9c1661a651213e2d, 0x06bea10ca65c084e,
+    0xc31bfa0fe5698db8, 0x486e494fcff30a62,
+    0xf3e2f893dec3f126, 0x5a89dba3c3efccfa,
+    0x986ddb5c6b3a76b7, 0xf89629465a75e01c,
+    0xbe89523386091465, 0xf6bbb397f1135823,
+    0xee2ba6c0678b597f, 0x746aa07ded582e2c,
+    0x94db483840b717ef, 0xa8c2a44eb4571cdc,
+    0xba121a4650e4ddeb, 0x92f34d62616ce413,
+    0xe896a0d7e51e1566, 0x77b020baf9c81d17,
+    0x915e2486ef32cd60, 0x0ace1474dc1d122e,
+    0xb5b5ada8aaff80b8, 0x0d819992132456ba,
+    0xe3231912d5bf60e6, 0x10e1fff697ed6c69,
+    0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1,
+    0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2,
+    0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde,
+    0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b,
+    0xad4ab7112eb3929d, 0x86c16c98d2c953c6,
+    0xd89d64d57a607744, 0xe871c7bf077ba8b7,
+    0x87625f056c7c4a8b, 0x11471cd764ad4972,
+    0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf,
+    0xd389b47879823479, 0x4aff1d108d4ec2c3,
+    0x843610cb4bf160cb, 0xcedf722a585139ba,
+    0xa54394fe1eedb8fe, 0xc2974eb4ee658828,
+    0xce947a3da6a9273e, 0x733d226229feea32,
+    0x811ccc668829b887, 0x0806357d5a3f525f,
+    0xa163ff802a3426a8, 0xca07c2dcb0cf26f7,
+    0xc9bcff6034c13052, 0xfc89b393dd02f0b5,
+    0xfc2c3f3841f17c67, 0xbbac2078d443ace2,
+    0x9d9ba7832936edc0, 0xd54b944b84aa4c0d,
+    0xc5029163f384a931, 0x0a9e795e65d4df11,
+    0xf64335bcf065d37d, 0x4d4617b5ff4a16d5,
+    0x99ea0196163fa42e, 0x504bced1bf8e4e45,
+    0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6,
+    0xf07da27a82c37088, 0x5d767327bb4e5a4c,
+    0x964e858c91ba2655, 0x3a6a07f8d510f86f,
+    0xbbe226efb628afea, 0x890489f70a55368b,
+    0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e,
+    0x92c8ae6b464fc96f, 0x3b0b8bc90012929d,
+    0xb77ada0617e3bbcb, 0x09ce6ebb40173744,
+    0xe55990879ddcaabd, 0xcc420a6a101d0515,
+    0x8f57fa54c2a9eab6, 0x9fa946824a12232d,
+    0xb32df8e9f3546564, 0x47939822dc96abf9,
+    0xdff9772470297ebd, 0x59787e2b93bc56f7,
+    0x8bfbea76c619ef36, 0x57eb4edb3c55b65a,
+    0xaefae51477a06b03, 0xede622920b6b23f1,
+    0xdab99e59958885c4, 0xe95fab368e45eced,
+    0x88b402f7fd75539b, 0x11dbcb0218ebb414,
+    0xaae103b5fcd2a881, 0xd652bdc29f26a119,
+    0xd59944a37c0752a2, 0x4be76d3346f0495f,
+    0x857fcae62d8493a5, 0x6f70a4400c562ddb,
+    0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952,
+    0xd097ad07a71f26b2, 0x7e2000a41346a7a7,
+    0x825ecc24c873782f, 0x8ed400668c0c28c8,
+    0xa2f67f2dfa90563b, 0x728900802f0f32fa,
+    0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9,
+    0xfea126b7d78186bc, 0xe2f610c84987bfa8,
+    0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9,
+    0xc6ede63fa05d3143, 0x91503d1c79720dbb,
+    0xf8a95fcf88747d94, 0x75a44c6397ce912a,
+    0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba,
+    0xc24452da229b021b, 0xfbe85badce996168,
+    0xf2d56790ab41c2a2, 0xfae27299423fb9c3,
+    0x97c560ba6b0919a5, 0xdccd879fc967d41a,
+    0xbdb6b8e905cb600f, 0x5400e987bbc1c920,
+    0xed246723473e3813, 0x290123e9aab23b68,
+    0x9436c0760c86e30b, 0xf9a0b6720aaf6521,
+    0xb94470938fa89bce, 0xf808e40e8d5b3e69,
+    0xe7958cb87392c2c2, 0xb60b1d1230b20e04,
+    0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2,
+    0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3,
+    0xe2280b6c20dd5232, 0x25c6da63c38de1b0,
+    0x8d590723948a535f, 0x579c487e5a38ad0e,
+    0xb0af48ec79ace837, 0x2d835a9df0c6d851,
+    0xdcdb1b2798182244, 0xf8e431456cf88e65,
+    0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff,
+    0xac8b2d36eed2dac5, 0xe272467e3d222f3f,
+    0xd7adf884aa879177, 0x5b0ed81dcc6abb0f,
+    0x86ccbb52ea94baea, 0x98e947129fc2b4e9,
+    0xa87fea27a539e9a5, 0x3f2398d747b36224,
+    0xd29fe4b18e88640e, 0x8eec7f0d19a03aad,
+    0x83a3eeeef9153e89, 0x1953cf68300424ac,
+    0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7,
+    0xcdb02555653131b6, 0x3792f412cb06794d,
+    0x808e17555f3ebf11, 0xe2bbd88bbee40bd0,
+    0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4,
+    0xc8de047564d20a8b, 0xf245825a5a445275,
+    0xfb158592be068d2e, 0xeed6e2f0f0d56712,
+    0x9ced737bb6c4183d, 0x55464dd69685606b,
+    0xc428d05aa4751e4c, 0xaa97e14c3c26b886,
+    0xf53304714d9265df, 0xd53dd99f4b3066a8,
+    0x993fe2c6d07b7fab, 0xe546a8038efe4029,
+    0xbf8fdb78849a5f96, 0xde98520472bdd033,
+    0xef73d256a5c0f77c, 0x963e66858f6d4440,
+    0x95a8637627989aad, 0xdde7001379a44aa8,
+    0xbb127c53b17ec159, 0x5560c018580d5d52,
+    0xe9d71b689dde71af, 0xaab8f01e6e10b4a6,
+    0x9226712162ab070d, 0xcab3961304ca70e8,
+    0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22,
+    0xe45c10c42a2b3b05, 0x8cb89a7db77c506a,
+    0x8eb98a7a9a5b04e3, 0x77f3608e92adb242,
+    0xb267ed1940f1c61c, 0x55f038b237591ed3,
+    0xdf01e85f912e37a3, 0x6b6c46dec52f6688,
+    0x8b61313bbabce2c6, 0x2323ac4b3b3da015,
+    0xae397d8aa96c1b77, 0xabec975e0a0d081a,
+    0xd9c7dced53c72255, 0x96e7bd358c904a21,
+    0x881cea14545c7575, 0x7e50d64177da2e54,
+    0xaa242499697392d2, 0xdde50bd1d5d0b9e9,
+    0xd4ad2dbfc3d07787, 0x955e4ec64b44e864,
+    0x84ec3c97da624ab4, 0xbd5af13bef0b113e,
+    0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e,
+    0xcfb11ead453994ba, 0x67de18eda5814af2,
+    0x81ceb32c4b43fcf4, 0x80eacf948770ced7,
+    0xa2425ff75e14fc31, 0xa1258379a94d028d,
+    0xcad2f7f5359a3b3e, 0x096ee45813a04330,
+    0xfd87b5f28300ca0d, 0x8bca9d6e188853fc,
+    0x9e74d1b791e07e48, 0x775ea264cf55347e,
+    0xc612062576589dda, 0x95364afe032a819e,
+    0xf79687aed3eec551, 0x3a83ddbd83f52205,
+    0x9abe14cd44753b52, 0xc4926a9672793543,
+    0xc16d9a0095928a27, 0x75b7053c0f178294,
+    0xf1c90080baf72cb1, 0x5324c68b12dd6339,
+    0x971da05074da7bee, 0xd3f6fc16ebca5e04,
+    0xbce5086492111aea, 0x88f4bb1ca6bcf585,
+    0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6,
+    0x9392ee8e921d5d07, 0x3aff322e62439fd0,
+    0xb877aa3236a4b449, 0x09befeb9fad487c3,
+    0xe69594bec44de15b, 0x4c2ebe687989a9b4,
+    0x901d7cf73ab0acd9, 0x0f9d37014bf60a11,
+    0xb424dc35095cd80f, 0x538484c19ef38c95,
+    0xe12e13424bb40e13, 0x2865a5f206b06fba,
+    0x8cbccc096f5088cb, 0xf93f87b7442e45d4,
+    0xafebff0bcb24aafe, 0xf78f69a51539d749,
+    0xdbe6fecebdedd5be, 0xb573440e5a884d1c,
+    0x89705f4136b4a597, 0x31680a88f8953031,
+    0xabcc77118461cefc, 0xfdc20d2b36ba7c3e,
+    0xd6bf94d5e57a42bc, 0x3d32907604691b4d,
+    0x8637bd05af6c69b5, 0xa63f9a49c2c1b110,
+    0xa7c5ac471b478423, 0x0fcf80dc33721d54,
+    0xd1b71758e219652b, 0xd3c36113404ea4a9,
+    0x83126e978d4fdf3b, 0x645a1cac083126ea,
+    0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4,
+    0xcccccccccccccccc, 0xcccccccccccccccd,
+    0x8000000000000000, 0x0000000000000000,
+    0xa000000000000000, 0x0000000000000000,
+    0xc800000000000000, 0x0000000000000000,
+    0xfa00000000000000, 0x0000000000000000,
+    0x9c40000000000000, 0x0000000000000000,
+    0xc350000000000000, 0x0000000000000000,
+    0xf424000000000000, 0x0000000000000000,
+    0x9896800000000000, 0x0000000000000000,
+    0xbebc200000000000, 0x0000000000000000,
+    0xee6b280000000000, 0x0000000000000000,
+    0x9502f90000000000, 0x0000000000000000,
+    0xba43b74000000000, 0x0000000000000000,
+    0xe8d4a51000000000, 0x0000000000000000,
+    0x9184e72a00000000, 0x0000000000000000,
+    0xb5e620f480000000, 0x0000000000000000,
+    0xe35fa931a0000000, 0x0000000000000000,
+    0x8e1bc9bf04000000, 0x0000000000000000,
+    0xb1a2bc2ec5000000, 0x0000000000000000,
+    0xde0b6b3a76400000, 0x0000000000000000,
+    0x8ac7230489e80000, 0x0000000000000000,
+    0xad78ebc5ac620000, 0x0000000000000000,
+    0xd8d726b7177a8000, 0x0000000000000000,
+    0x878678326eac9000, 0x0000000000000000,
+    0xa968163f0a57b400, 0x0000000000000000,
+    0xd3c21bcecceda100, 0x0000000000000000,
+    0x84595161401484a0, 0x0000000000000000,
+    0xa56fa5b99019a5c8, 0x0000000000000000,
+    0xcecb8f27f4200f3a, 0x0000000000000000,
+    0x813f3978f8940984, 0x4000000000000000,
+    0xa18f07d736b90be5, 0x5000000000000000,
+    0xc9f2c9cd04674ede, 0xa400000000000000,
+    0xfc6f7c4045812296, 0x4d00000000000000,
+    0x9dc5ada82b70b59d, 0xf020000000000000,
+    0xc5371912364ce305, 0x6c28000000000000,
+    0xf684df56c3e01bc6, 0xc732000000000000,
+    0x9a130b963a6c115c, 0x3c7f400000000000,
+    0xc097ce7bc90715b3, 0x4b9f100000000000,
+    0xf0bdc21abb48db20, 0x1e86d40000000000,
+    0x96769950b50d88f4, 0x1314448000000000,
+    0xbc143fa4e250eb31, 0x17d955a000000000,
+    0xeb194f8e1ae525fd, 0x5dcfab0800000000,
+    0x92efd1b8d0cf37be, 0x5aa1cae500000000,
+    0xb7abc627050305ad, 0xf14a3d9e40000000,
+    0xe596b7b0c643c719, 0x6d9ccd05d0000000,
+    0x8f7e32ce7bea5c6f, 0xe4820023a2000000,
+    0xb35dbf821ae4f38b, 0xdda2802c8a800000,
+    0xe0352f62a19e306e, 0xd50b2037ad200000,
+    0x8c213d9da502de45, 0x4526f422cc340000,
+    0xaf298d050e4395d6, 0x9670b12b7f410000,
+    0xdaf3f04651d47b4c, 0x3c0cdd765f114000,
+    0x88d8762bf324cd0f, 0xa5880a69fb6ac800,
+    0xab0e93b6efee0053, 0x8eea0d047a457a00,
+    0xd5d238a4abe98068, 0x72a4904598d6d880,
+    0x85a36366eb71f041, 0x47a6da2b7f864750,
+    0xa70c3c40a64e6c51, 0x999090b65f67d924,
+    0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d,
+    0x82818f1281ed449f, 0xbff8f10e7a8921a4,
+    0xa321f2d7226895c7, 0xaff72d52192b6a0d,
+    0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490,
+    0xfee50b7025c36a08, 0x02f236d04753d5b4,
+    0x9f4f2726179a2245, 0x01d762422c946590,
+    0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5,
+    0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2,
+    0x9b934c3b330c8577, 0x63cc55f49f88eb2f,
+    0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb,
+    0xf316271c7fc3908a, 0x8bef464e3945ef7a,
+    0x97edd871cfda3a56, 0x97758bf0e3cbb5ac,
+    0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317,
+    0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd,
+    0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a,
+    0xb975d6b6ee39e436, 0xb3e2fd538e122b44,
+    0xe7d34c64a9c85d44, 0x60dbbca87196b616,
+    0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd,
+    0xb51d13aea4a488dd, 0x6babab6398bdbe41,
+    0xe264589a4dcdab14, 0xc696963c7eed2dd1,
+    0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2,
+    0xb0de65388cc8ada8, 0x3b25a55f43294bcb,
+    0xdd15fe86affad912, 0x49ef0eb713f39ebe,
+    0x8a2dbf142dfcc7ab, 0x6e3569326c784337,
+    0xacb92ed9397bf996, 0x49c2c37f07965404,
+    0xd7e77a8f87daf7fb, 0xdc33745ec97be906,
+    0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3,
+    0xa8acd7c0222311bc, 0xc40832ea0d68ce0c,
+    0xd2d80db02aabd62b, 0xf50a3fa490c30190,
+    0x83c7088e1aab65db, 0x792667c6da79e0fa,
+    0xa4b8cab1a1563f52, 0x577001b891185938,
+    0xcde6fd5e09abcf26, 0xed4c0226b55e6f86,
+    0x80b05e5ac60b6178, 0x544f8158315b05b4,
+    0xa0dc75f1778e39d6, 0x696361ae3db1c721,
+    0xc913936dd571c84c, 0x03bc3a19cd1e38e9,
+    0xfb5878494ace3a5f, 0x04ab48a04065c723,
+    0x9d174b2dcec0e47b, 0x62eb0d64283f9c76,
+    0xc45d1df942711d9a, 0x3ba5d0bd324f8394,
+    0xf5746577930d6500, 0xca8f44ec7ee36479,
+    0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb,
+    0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e,
+    0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e,
+    0x95d04aee3b80ece5, 0xbba1f1d158724a12,
+    0xbb445da9ca61281f, 0x2a8a6e45ae8edc97,
+    0xea1575143cf97226, 0xf52d09d71a3293bd,
+    0x924d692ca61be758, 0x593c2626705f9c56,
+    0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c,
+    0xe498f455c38b997a, 0x0b6dfb9c0f956447,
+    0x8edf98b59a373fec, 0x4724bd4189bd5eac,
+    0xb2977ee300c50fe7, 0x58edec91ec2cb657,
+    0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed,
+    0x8b865b215899f46c, 0xbd79e0d20082ee74,
+    0xae67f1e9aec07187, 0xecd8590680a3aa11,
+    0xda01ee641a708de9, 0xe80e6f4820cc9495,
+    0x884134fe908658b2, 0x3109058d147fdcdd,
+    0xaa51823e34a7eede, 0xbd4b46f0599fd415,
+    0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a,
+    0x850fadc09923329e, 0x03e2cf6bc604ddb0,
+    0xa6539930bf6bff45, 0x84db8346b786151c,
+    0xcfe87f7cef46ff16, 0xe612641865679a63,
+    0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e,
+    0xa26da3999aef7749, 0xe3be5e330f38f09d,
+    0xcb090c8001ab551c, 0x5cadf5bfd3072cc5,
+    0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6,
+    0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa,
+    0xc646d63501a1511d, 0xb281e1fd541501b8,
+    0xf7d88bc24209a565, 0x1f225a7ca91a4226,
+    0x9ae757596946075f, 0x3375788de9b06958,
+    0xc1a12d2fc3978937, 0x0052d6b1641c83ae,
+    0xf209787bb47d6b84, 0xc0678c5dbd23a49a,
+    0x9745eb4d50ce6332, 0xf840b7ba963646e0,
+    0xbd176620a501fbff, 0xb650e5a93bc3d898,
+    0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe,
+    0x93ba47c980e98cdf, 0xc66f336c36b10137,
+    0xb8a8d9bbe123f017, 0xb80b0047445d4184,
+    0xe6d3102ad96cec1d, 0xa60dc059157491e5,
+    0x9043ea1ac7e41392, 0x87c89837ad68db2f,
+    0xb454e4a179dd1877, 0x29babe4598c311fb,
+    0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a,
+    0x8ce2529e2734bb1d, 0x1899e4a65f58660c,
+    0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f,
+    0xdc21a1171d42645d, 0x76707543f4fa1f73,
+    0x899504ae72497eba, 0x6a06494a791c53a8,
+    0xabfa45da0edbde69, 0x0487db9d17636892,
+    0xd6f8d7509292d603, 0x45a9d2845d3c42b6,
+    0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2,
+    0xa7f26836f282b732, 0x8e6cac7768d7141e,
+    0xd1ef0244af2364ff, 0x3207d795430cd926,
+    0x8335616aed761f1f, 0x7f44e6bd49e807b8,
+    0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6,
+    0xcd036837130890a1, 0x36dba887c37a8c0f,
+    0x802221226be55a64, 0xc2494954da2c9789,
+    0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c,
+    0xc83553c5c8965d3d, 0x6f92829494e5acc7,
+    0xfa42a8b73abbf48c, 0xcb772339ba1f17f9,
+    0x9c69a97284b578d7, 0xff2a760414536efb,
+    0xc38413cf25e2d70d, 0xfef5138519684aba,
+    0xf46518c2ef5b8cd1, 0x7eb258665fc25d69,
+    0x98bf2f79d5993802, 0xef2f773ffbd97a61,
+    0xbeeefb584aff8603, 0xaafb550ffacfd8fa,
+    0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38,
+    0x952ab45cfa97a0b2, 0xdd945a747bf26183,
+    0xba756174393d88df, 0x94f971119aeef9e4,
+    0xe912b9d1478ceb17, 0x7a37cd5601aab85d,
+    0x91abb422ccb812ee, 0xac62e055c10ab33a,
+    0xb616a12b7fe617aa, 0x577b986b314d6009,
+    0xe39c49765fdf9d94, 0xed5a7e85fda0b80b,
+    0x8e41ade9fbebc27d, 0x14588f13be847307,
+    0xb1d219647ae6b31c, 0x596eb2d8ae258fc8,
+    0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb,
+    0x8aec23d680043bee, 0x25de7bb9480d5854,
+    0xada72ccc20054ae9, 0xaf561aa79a10ae6a,
+    0xd910f7ff28069da4, 0x1b2ba1518094da04,
+    0x87aa9aff79042286, 0x90fb44d2f05d0842,
+    0xa99541bf57452b28, 0x353a1607ac744a53,
+    0xd3fa922f2d1675f2, 0x42889b8997915ce8,
+    0x847c9b5d7c2e09b7, 0x69956135febada11,
+    0xa59bc234db398c25, 0x43fab9837e699095,
+    0xcf02b2c21207ef2e, 0x94f967e45e03f4bb,
+    0x8161afb94b44f57d, 0x1d1be0eebac278f5,
+    0xa1ba1ba79e1632dc, 0x6462d92a69731732,
+    0xca28a291859bbf93, 0x7d7b8f7503cfdcfe,
+    0xfcb2cb35e702af78, 0x5cda735244c3d43e,
+    0x9defbf01b061adab, 0x3a0888136afa64a7,
+    0xc56baec21c7a1916, 0x088aaa1845b8fdd0,
+    0xf6c69a72a3989f5b, 0x8aad549e57273d45,
+    0x9a3c2087a63f6399, 0x36ac54e2f678864b,
+    0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd,
+    0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5,
+    0x969eb7c47859e743, 0x9f644ae5a4b1b325,
+    0xbc4665b596706114, 0x873d5d9f0dde1fee,
+    0xeb57ff22fc0c7959, 0xa90cb506d155a7ea,
+    0x9316ff75dd87cbd8, 0x09a7f12442d588f2,
+    0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f,
+    0xe5d3ef282a242e81, 0x8f1668c8a86da5fa,
+    0x8fa475791a569d10, 0xf96e017d694487bc,
+    0xb38d92d760ec4455, 0x37c981dcc395a9ac,
+    0xe070f78d3927556a, 0x85bbe253f47b1417,
+    0x8c469ab843b89562, 0x93956d7478ccec8e,
+    0xaf58416654a6babb, 0x387ac8d1970027b2,
+    0xdb2e51bfe9d0696a, 0x06997b05fcc0319e,
+    0x88fcf317f22241e2, 0x441fece3bdf81f03,
+    0xab3c2fddeeaad25a, 0xd527e81cad7626c3,
+    0xd60b3bd56a5586f1, 0x8a71e223d8d3b074,
+    0x85c7056562757456, 0xf6872d5667844e49,
+    0xa738c6bebb12d16c, 0xb428f8ac016561db,
+    0xd106f86e69d785c7, 0xe13336d701beba52,
+    0x82a45b450226b39c, 0xecc0024661173473,
+    0xa34d721642b06084, 0x27f002d7f95d0190,
+    0xcc20ce9bd35c78a5, 0x31ec038df7b441f4,
+    0xff290242c83396ce, 0x7e67047175a15271,
+    0x9f79a169bd203e41, 0x0f0062c6e984d386,
+    0xc75809c42c684dd1, 0x52c07b78a3e60868,
+    0xf92e0c3537826145, 0xa7709a56ccdf8a82,
+    0x9bbcc7a142b17ccb, 0x88a66076400bb691,
+    0xc2abf989935ddbfe, 0x6acff893d00ea435,
+    0xf356f7ebf83552fe, 0x0583f6b8c4124d43,
+    0x98165af37b2153de, 0xc3727a337a8b704a,
+    0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c,
+    0xeda2ee1c7064130c, 0x1162def06f79df73,
+    0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8,
+    0xb9a74a0637ce2ee1, 0x6d953e2bd7173692,
+    0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437,
+    0x910ab1d4db9914a0, 0x1d9c9892400a22a2,
+    0xb54d5e4a127f59c8, 0x2503beb6d00cab4b,
+    0xe2a0b5dc971f303a, 0x2e44ae64840fd61d,
+    0x8da471a9de737e24, 0x5ceaecfed289e5d2,
+    0xb10d8e1456105dad, 0x7425a83e872c5f47,
+    0xdd50f1996b947518, 0xd12f124e28f77719,
+    0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f,
+    0xace73cbfdc0bfb7b, 0x636cc64d1001550b,
+    0xd8210befd30efa5a, 0x3c47f7e05401aa4e,
+    0x8714a775e3e95c78, 0x65acfaec34810a71,
+    0xa8d9d1535ce3b396, 0x7f1839a741a14d0d,
+    0xd31045a8341ca07c, 0x1ede48111209a050,
+    0x83ea2b892091e44d, 0x934aed0aab460432,
+    0xa4e4b66b68b65d60, 0xf81da84d5617853f,
+    0xce1de40642e3f4b9, 0x36251260ab9d668e,
+    0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019,
+    0xa1075a24e4421730, 0xb24cf65b8612f81f,
+    0xc94930ae1d529cfc, 0xdee033f26797b627,
+    0xfb9b7cd9a4a7443c, 0x169840ef017da3b1,
+    0x9d412e0806e88aa5, 0x8e1f289560ee864e,
+    0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2,
+    0xf5b5d7ec8acb58a2, 0xae10af696774b1db,
+    0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29,
+    0xbff610b0cc6edd3f, 0x17fd090a58d32af3,
+    0xeff394dcff8a948e, 0xddfc4b4cef07f5b0,
+    0x95f83d0a1fb69cd9, 0x4abdaf101564f98e,
+    0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1,
+    0xea53df5fd18d5513, 0x84c86189216dc5ed,
+    0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4,
+    0xb7118682dbb66a77, 0x3fbc8c33221dc2a1,
+    0xe4d5e82392a40515, 0x0fabaf3feaa5334a,
+    0x8f05b1163ba6832d, 0x29cb4d87f2a7400e,
+    0xb2c71d5bca9023f8, 0x743e20e9ef511012,
+    0xdf78e4b2bd342cf6, 0x914da9246b255416,
+    0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e,
+    0xae9672aba3d0c320, 0xa184ac2473b529b1,
+    0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e,
+    0x8865899617fb1871, 0x7e2fa67c7a658892,
+    0xaa7eebfb9df9de8d, 0xddbb901b98feeab7,
+    0xd51ea6fa85785631, 0x552a74227f3ea565,
+    0x8533285c936b35de, 0xd53a88958f87275f,
+    0xa67ff273b8460356, 0x8a892abaf368f137,
+    0xd01fef10a657842c, 0x2d2b7569b0432d85,
+    0x8213f56a67f6b29b, 0x9c3b29620e29fc73,
+    0xa298f2c501f45f42, 0x8349f3ba91b47b8f,
+    0xcb3f2f7642717713, 0x241c70a936219a73,
+    0xfe0efb53d30dd4d7, 0xed238cd383aa0110,
+    0x9ec95d1463e8a506, 0xf4363804324a40aa,
+    0xc67bb4597ce2ce48, 0xb143c6053edcd0d5,
+    0xf81aa16fdc1b81da, 0xdd94b7868e94050a,
+    0x9b10a4e5e9913128, 0xca7cf2b4191c8326,
+    0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0,
+    0xf24a01a73cf2dccf, 0xbc633b39673c8cec,
+    0x976e41088617ca01, 0xd5be0503e085d813,
+    0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18,
+    0xec9c459d51852ba2, 0xddf8e7d60ed1219e,
+    0x93e1ab8252f33b45, 0xcabb90e5c942b503,
+    0xb8da1662e7b00a17, 0x3d6a751f3b936243,
+    0xe7109bfba19c0c9d, 0x0cc512670a783ad4,
+    0x906a617d450187e2, 0x27fb2b80668b24c5,
+    0xb484f9dc9641e9da, 0xb1f9f660802dedf6,
+    0xe1a63853bbd26451, 0x5e7873f8a0396973,
+    0x8d07e33455637eb2, 0xdb0b487b6423e1e8,
+    0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62,
+    0xdc5c5301c56b75f7, 0x7641a140cc7810fb,
+    0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d,
+    0xac2820d9623bf429, 0x546345fa9fbdcd44,
+    0xd732290fbacaf133, 0xa97c177947ad4095,
+    0x867f59a9d4bed6c0, 0x49ed8eabcccc485d,
+    0xa81f301449ee8c70, 0x5c68f256bfff5a74,
+    0xd226fc195c6a2f8c, 0x73832eec6fff3111,
+    0x83585d8fd9c25db7, 0xc831fd53c5ff7eab,
+    0xa42e74f3d032f525, 0xba3e7ca8b77f5e55,
+    0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb,
+    0x80444b5e7aa7cf85, 0x7980d163cf5b81b3,
+    0xa0555e361951c366, 0xd7e105bcc332621f,
+    0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7,
+    0xfa856334878fc150, 0xb14f98f6f0feb951,
+    0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3,
+    0xc3b8358109e84f07, 0x0a862f80ec4700c8,
+    0xf4a642e14c6262c8, 0xcd27bb612758c0fa,
+    0x98e7e9cccfbd7dbd, 0x8038d51cb897789c,
+    0xbf21e44003acdd2c, 0xe0470a63e6bd56c3,
+    0xeeea5d5004981478, 0x1858ccfce06cac74,
+    0x95527a5202df0ccb, 0x0f37801e0c43ebc8,
+    0xbaa718e68396cffd, 0xd30560258f54e6ba,
+    0xe950df20247c83fd, 0x47c6b82ef32a2069,
+    0x91d28b7416cdd27e, 0x4cdc331d57fa5441,
+    0xb6472e511c81471d, 0xe0133fe4adf8e952,
+    0xe3d8f9e563a198e5, 0x58180fddd97723a6,
+    0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648,
+};
+
+struct Uint128 {
+    uint64_t low;
+    uint64_t high;
+};
+
+inline Uint128 full_multiplication(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = __uint128_t(a) * b;
+    return {uint64_t(r), uint64_t(r >> 64)};
+#else
+    uint64_t a_lo = uint32_t(a), a_hi = a >> 32;
+    uint64_t b_lo = uint32_t(b), b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + uint32_t(hi_lo) + lo_hi;
+    return {(cross << 32) | uint32_t(lo_lo),
+            (hi_lo >> 32) + (cross >> 32) + hi_hi};
+#endif
+}
+
+inline int clz64(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(bits);
+#else
+    int n = 0;
+    while (!(bits & (uint64_t(1) << 63))) {
+        bits <<= 1;
+        ++n;
     }
+    return n;
+#endif
+}
 
-    size_t get_object_size() const {
-        check_type(Type::kObject, "object");
-        return value_.object->size();
+// double 的尾数 (不含隐含位) 与带偏置的指数, power2 == 0x7FF 表示无穷
+struct AdjustedMantissa {
+    uint64_t mantissa;
+    int32_t power2;
+
+    bool operator==(const AdjustedMantissa &o) const {
+        return mantissa == o.mantissa && power2 == o.power2;
     }
+    bool operator!=(const AdjustedMantissa &o) const { return !(*this == o); }
+};
 
-    size_t get_object_key_length(size_t idx) const {
-        check_type(Type::kObject, "object");
-        auto it = value_.object->begin();
-        std::advance(it, idx);
-        return it->first.size();
+inline constexpr int kMantissaBits = 52;
+inline constexpr int kInfinitePower = 0x7FF;
+
+// w * 10^q 就近舍入 (偶数优先) 到 double. w 为不超过 19 位的十进制整数,
+// 128 位的 5^q 近似对这个范围总是足够 (Mushtak & Lemire, 2023)
+inline AdjustedMantissa compute_float(int64_t q, uint64_t w) {
+    if (w == 0 || q < kSmallestPowerOfTen) return {0, 0};
+    if (q > kLargestPowerOfTen) return {0, kInfinitePower};
+
+    int lz = clz64(w);
+    w <<= lz;
+
+    size_t index = 2 * size_t(q - kSmallestPowerOfTen);
+    Uint128 product = full_multiplication(w, kPowerOfFive128[index]);
+    const uint64_t precision_mask = ~uint64_t(0) >> (kMantissaBits + 3);
+    if ((product.high & precision_mask) == precision_mask) {
+        Uint128 second = full_multiplication(w, kPowerOfFive128[index + 1]);
+        product.low += second.high;
+        if (second.high > product.low) ++product.high;
     }
 
-    const char *get_object_key(size_t idx) const {
-        check_type(Type::kObject, "object");
-        auto it = value_.object->begin();
-        std::advance(it, idx);
-        return it->first.c_str();
+    int upperbit = int(product.high >> 63);
+    int shift = upperbit + 64 - kMantissaBits - 3;
+    // floor(log2(10^q)) + 63 == (217706 * q) >> 16 + 63
+    int32_t power = int32_t(((152170 + 65536) * q) >> 16) + 63;
+
+    AdjustedMantissa am;
+    am.mantissa = product.high >> shift;
+    am.power2 = power + upperbit - lz + 1023;
+    if (am.power2 <= 0) {
+        // 非规格化数
+        if (-am.power2 + 1 >= 64) return {0, 0};
+        am.mantissa >>= -am.power2 + 1;
+        am.mantissa += am.mantissa & 1;
+        am.mantissa >>= 1;
+        am.power2 = am.mantissa < (uint64_t(1) << kMantissaBits) ? 0 : 1;
+        return am;
     }
 
-    Json &get_object_value(size_t idx) const {
-        check_type(Type::kObject, "object");
-        auto it = value_.object->begin();
-        std::advance(it, idx);
-        return it->second;
+    // 恰好落在两个 double 正中间时偶数优先, 只可能出现在 q ∈ [-4, 23]
+    if (product.low <= 1 && q >= -4 && q <= 23 && (am.mantissa & 3) == 1 &&
+        (am.mantissa << shift) == product.high) {
+        am.mantissa &= ~uint64_t(1);
     }
 
-    void stack_push(char ch) { stack_.push_back(ch); }
+    am.mantissa += am.mantissa & 1;
+    am.mantissa >>= 1;
+    if (am.mantissa >= (uint64_t(2) << kMantissaBits)) {
+        am.mantissa = uint64_t(1) << kMantissaBits;
+        ++am.power2;
+    }
+    am.mantissa &= ~(uint64_t(1) << kMantissaBits);
+    if (am.power2 >= kInfinitePower) return {0, kInfinitePower};
+    return am;
+}
 
-    void stack_push(const char *s) {
-        while (*s) stack_.push_back(*s++);
+// 精确比较用的定长大整数, 容量足够容纳 800 位十进制数乘上 double 的指数范围
+class Bigint {
+public:
+    explicit Bigint(uint64_t value) {
+        limbs_[0] = uint32_t(value);
+        limbs_[1] = uint32_t(value >> 32);
+        size_ = limbs_[1] ? 2 : limbs_[0] ? 1 : 0;
     }
 
-    Ret parse_text(const char *&text) {
-        parse_whitespace(text);
-        if (!*text) return Ret::kParseExpectValue;
-        switch (*text) {
-            case 'n': return parse_literal(text, kLiteralNull, Type::kNull);
-            case 't': return parse_boolean(text, kLiteralTrue, true);
-            case 'f': return parse_boolean(text, kLiteralFalse, false);
-            case '\"': return parse_string(text);
-            case '[': return parse_array(text);
-            case '{': return parse_object(text);
-            default: return parse_number(text);
+    void mul_small(uint32_t m) {
+        uint64_t carry = 0;
+        for (int i = 0; i < size_; ++i) {
+            uint64_t t = uint64_t(limbs_[i]) * m + carry;
+            limbs_[i] = uint32_t(t);
+            carry = t >> 32;
         }
-        return Ret::kParseInvalidValue;
+        if (carry) limbs_[size_++] = uint32_t(carry);
     }
 
-    void check_type(Type type, const char *msg) const {
-        if (type_ != type) {
-            std::string error_msg =
-                std::string("text value isn't' ") + msg + "!";
-            throw std::runtime_error(error_msg);
+    void add_small(uint32_t a) {
+        for (int i = 0; a && i < size_; ++i) {
+            uint64_t t = uint64_t(limbs_[i]) + a;
+            limbs_[i] = uint32_t(t);
+            a = uint32_t(t >> 32);
         }
+        if (a) limbs_[size_++] = a;
     }
 
-    /* ws = *(%x20 / %x09 / %x0A / %x0D) */
-    void parse_whitespace(const char *&text) {
-        while (*text == ' ' || *text == '\t' || *text == '\n' ||
-               *text == '\r') {
-            ++text;
-        }
+    void mul_pow5(int n) {
+        static const uint32_t kPow5[] = {
+            1,       5,        25,       125,       625,        3125,    15625,
+            78125,   390625,   1953125,  9765625,   48828125,   244140625,
+            1220703125};
+        for (; n >= 13; n -= 13) mul_small(kPow5[13]);
+        mul_small(kPow5[n]);
     }
 
-    Ret parse_literal(const char *&text, std::string_view literal, Type type) {
-        for (char c : literal) {
-            if (*text++ != c) return Ret::kParseInvalidValue;
+    void shl(int n) {
+        if (size_ == 0) return;
+        int limbs = n / 32, bits = n % 32;
+        if (bits) {
+            uint32_t carry = 0;
+            for (int i = 0; i < size_; ++i) {
+                uint32_t limb = limbs_[i];
+                limbs_[i] = limb << bits | carry;
+                carry = limb >> (32 - bits);
+            }
+            if (carry) limbs_[size_++] = carry;
+        }
+        if (limbs) {
+            memmove(limbs_ + limbs, limbs_, size_ * sizeof(uint32_t));
+            memset(limbs_, 0, limbs * sizeof(uint32_t));
+            size_ += limbs;
         }
-        type_ = type;
-        return Ret::kParseOk;
     }
 
-    Ret parse_boolean(const char *&text, std::string_view literal, Boolean b) {
-        for (char c : literal) {
-            if (*text++ != c) return Ret::kParseInvalidValue;
+    int compare(const Bigint &o) const {
+        if (size_ != o.size_) return size_ < o.size_ ? -1 : 1;
+        for (int i = size_ - 1; i >= 0; --i) {
+            if (limbs_[i] != o.limbs_[i]) {
+                return limbs_[i] < o.limbs_[i] ? -1 : 1;
+            }
         }
-        type_ = Type::kBoolean;
-        value_.boolean = b;
-        return Ret::kParseOk;
+        return 0;
     }
 
-    Ret parse_number(const char *&text) {
-        // TODO 暂时使用系统库的解析方式匹配测试用例
-        // 检查
-        const char *p = text;
-        if (*p == '-') ++p;
-        if (*p == '0') {
-            ++p;
-        } else if (isdigit(*p)) {
-            ++p;
-            while (isdigit(*p)) ++p;
-        } else {
-            return Ret::kParseInvalidValue;
-        }
-        if (*p == '.') {
-            ++p;
-            if (!isdigit(*p)) return Ret::kParseInvalidValue;
-            ++p;
-            while (isdigit(*p)) ++p;
+private:
+    uint32_t limbs_[160];
+    int size_;
+};
+
+// 已按 JSON 语法校验过的十进制数: 整数部分、小数部分的数字区间与指数
+struct Decimal {
+    const char *int_begin;
+    const char *int_end;
+    const char *frac_begin;
+    const char *frac_end;
+    int64_t exponent;
+    uint64_t mantissa;  // 全部数字拼成的整数, 超过 19 位时无意义
+    bool negative;
+};
+
+// 有效数字超过 19 位、按前 19 位截断又无法确定舍入方向时, 用大整数把原数
+// 与候选值 am 和下一个 double 的中点精确比较
+inline AdjustedMantissa round_exact(const Decimal &d, const char *first,
+                                    AdjustedMantissa am) {
+    // 最多取 800 位有效数字, 其余只记录是否非零; 中点至多 768 位有效数字
+    const int kMaxDigits = 800;
+    Bigint lhs(0);
+    int digits = 0;
+    int64_t exp10 = d.exponent - (d.frac_end - d.frac_begin);
+    bool sticky = false;
+    uint32_t chunk = 0;
+    int chunk_len = 0;
+    for (const char *p = first; p != d.frac_end; ++p) {
+        if (p == d.int_end) p = d.frac_begin;
+        if (p == d.frac_end) break;
+        if (digits == kMaxDigits) {
+            sticky |= *p != '0';
+            ++exp10;
+            continue;
         }
-        if (*p == 'e' || *p == 'E') {
-            ++p;
-            if (*p == '+' || *p == '-') ++p;
-            if (!isdigit(*p)) return Ret::kParseInvalidValue;
-            ++p;
-            while (isdigit(*p)) ++p;
+        chunk = chunk * 10 + (*p - '0');
+        ++digits;
+        if (++chunk_len == 9) {
+            lhs.mul_small(1000000000);
+            lhs.add_small(chunk);
+            chunk = 0;
+            chunk_len = 0;
         }
+    }
+    static const uint32_t kPow10[] = {1,        10,        100,
+                                      1000,     10000,     100000,
+                                      1000000,  10000000,  100000000};
+    lhs.mul_small(kPow10[chunk_len]);
+    lhs.add_small(chunk);
 
-        double number = strtod(text, nullptr);
-        if (std::isinf(number)) return Ret::kParseNumberTooBig;
-
-        text = p;
-        type_ = Type::kNumber;
-        value_.number = number;
-        return Ret::kParseOk;
+    // 候选值 m * 2^e, 中点为 (2m + 1) * 2^(e - 1)
+    uint64_t m = am.mantissa;
+    int e = -1074;
+    if (am.power2 > 0) {
+        m |= uint64_t(1) << kMantissaBits;
+        e = am.power2 - 1075;
     }
+    Bigint rhs(2 * m + 1);
+    int lhs_shift = 0, rhs_shift = 0;
+    if (exp10 >= 0) {
+        lhs.mul_pow5(int(exp10));
+        lhs_shift += int(exp10);
+    } else {
+        rhs.mul_pow5(int(-exp10));
+        rhs_shift += int(-exp10);
+    }
+    if (e - 1 >= 0) {
+        rhs_shift += e - 1;
+    } else {
+        lhs_shift += 1 - e;
+    }
+    int common = lhs_shift < rhs_shift ? lhs_shift : rhs_shift;
+    lhs.shl(lhs_shift - common);
+    rhs.shl(rhs_shift - common);
 
-    static int ch2hex(char ch) {
-        int hex = 0;
-        if (ch >= '0' && ch <= '9') {
-            hex = ch - '0';
-        } else if (ch >= 'a' && ch <= 'f') {
-            hex = ch - 'a' + 10;
-        } else if (ch >= 'A' && ch <= 'F') {
-            hex = ch - 'A' + 10;
-        } else {
-            return -1;
+    int cmp = lhs.compare(rhs);
+    if (cmp > 0 || (cmp == 0 && (sticky || (m & 1)))) {
+        // 进位到下一个 double, 尾数溢出时指数加一 (含非规格化数到规格化数)
+        if (++am.mantissa == uint64_t(1) << kMantissaBits) {
+            am.mantissa = 0;
+            ++am.power2;
         }
-        return hex;
     }
+    return am;
+}
 
-    static int parse_hex4(const char *&text) {
-        int code = 0;
-        for (int i = 0; i < 4; ++i) {
-            int hex = ch2hex(*text++);
-            if (hex < 0) return -1;
-            code = (code << 4) + hex;
+inline double decimal_to_double(const Decimal &d) {
+    int64_t frac_len = d.frac_end - d.frac_begin;
+    int64_t q = d.exponent - frac_len;
+    uint64_t w = d.mantissa;
+    size_t digits = (d.int_end - d.int_begin) + frac_len;
+
+    AdjustedMantissa am;
+    const char *first = d.int_begin;
+    if (digits > 19) {
+        // 整数部分为 0 时跳过小数部分的前导 0 再数有效数字
+        if (*first == '0') {
+            first = d.frac_begin;
+            while (first != d.frac_end && *first == '0') ++first;
         }
-        return code;
+        digits = first < d.int_end
+                     ? (d.int_end - first) + frac_len
+                     : d.frac_end - first;
     }
 
-    Ret encode_utf8(const char *&text) {
-        int code = parse_hex4(text);
-        if (code < 0) return Ret::kParseInvalidUnicodeHex;
-        if (code >= 0xD800 && code < 0xDC00) {
-            if (*text++ != '\\' || *text++ != 'u') {
-                return Ret::kParseInvalidUnicodeSurrogate;
-            }
-            int surrogate = parse_hex4(text);
-            if (surrogate < 0 || !(surrogate >= 0xDC00 && surrogate < 0xE000)) {
-                return Ret::kParseInvalidUnicodeSurrogate;
-            }
-            code = 0x10000 + (code - 0xD800) * 0x400 + (surrogate - 0xDC00);
+    if (digits <= 19) {
+#if FLT_EVAL_METHOD == 0
+        // Clinger: 尾数与 10 的幂都能精确表示时, 一次乘除即正确舍入
+        static const double kExact[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                        1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                        1e18, 1e19, 1e20, 1e21, 1e22};
+        if (q >= -22 && q <= 22 && w <= (uint64_t(1) << 53)) {
+            double value = double(w);
+            value = q < 0 ? value / kExact[-q] : value * kExact[q];
+            return d.negative ? -value : value;
         }
-
-        if (code < 0x80) {
-            stack_push(code);
-        } else if (code < 0x800) {
-            stack_push(0xC0 | (0x1F & (code >> 6)));
-            stack_push(0X80 | (0x3F & code));
-        } else if (code < 0x10000) {
-            stack_push(0xE0 | (0x0F & (code >> 12)));
-            stack_push(0X80 | (0x3F & (code >> 6)));
-            stack_push(0X80 | (0x3F & code));
-        } else if (code < 0x10FFFF) {
-            stack_push(0xF0 | (0x07 & (code >> 18)));
-            stack_push(0X80 | (0x3F & (code >> 12)));
-            stack_push(0X80 | (0x3F & (code >> 6)));
-            stack_push(0X80 | (0x3F & code));
-        } else {
-            return Ret::kParseInvalidUnicodeHex;
+#endif
+        am = compute_float(q, w);
+    } else {
+        // 只取前 19 位有效数字, 真值落在 [w, w + 1) * 10^q 之间
+        w = 0;
+        const char *p = first;
+        for (int i = 0; i < 19; ++i, ++p) {
+            if (p == d.int_end) p = d.frac_begin;
+            w = w * 10 + (*p - '0');
         }
-        return Ret::kParseOk;
+        q += int64_t(digits) - 19;
+        am = compute_float(q, w);
+        if (am != compute_float(q, w + 1)) am = round_exact(d, first, am);
     }
 
-    Ret parse_string_raw(const char *&text) {
-        ++text;
-        while (*text && *text != '\"') {
-            unsigned char ch = *text++;
-            if (ch == '\\') {
-                switch (*text++) {
-                    case 'b': stack_push('\b'); break;
-                    case 'f': stack_push('\f'); break;
-                    case 'n': stack_push('\n'); break;
-                    case 'r': stack_push('\r'); break;
-                    case 't': stack_push('\t'); break;
-                    case '/': stack_push('/'); break;
-                    case '\"': stack_push('\"'); break;
-                    case '\\': stack_push('\\'); break;
-                    case 'u': {
-                        Ret ret = encode_utf8(text);
-                        if (ret != Ret::kParseOk) return ret;
-                    } break;
-                    default: return Ret::kParseInvalidStringEscape;
-                }
-            } else if (ch < 0x20) {
-                return Ret::kParseInvalidStringChar;
-            } else {
-                stack_push(ch);
-            }
-        }
-        if (*text++ != '\"') return Ret::kParseMissQuotationMark;
-        return Ret::kParseOk;
+    uint64_t bits = am.mantissa | uint64_t(am.power2) << kMantissaBits;
+    if (d.negative) bits |= uint64_t(1) << 63;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ---- double -> 最短十进制 (Grisu2) ----
+
+// 64 位尾数的浮点数 f * 2^e, 不做隐含位处理
+struct DiyFp {
+    uint64_t f;
+    int e;
+
+    DiyFp operator-(const DiyFp &o) const { return {f - o.f, e}; }
+
+    // 128 位乘积的高 64 位, 低位四舍五入
+    DiyFp operator*(const DiyFp &o) const {
+        Uint128 p = full_multiplication(f, o.f);
+        return {p.high + (p.low >> 63), e + o.e + 64};
     }
 
-    Ret parse_string(const char *&text) {
-        size_t old_top = stack_.size();
-        Ret ret = parse_string_raw(text);
-        if (ret != Ret::kParseOk) return ret;
-        value_.str =
-            new std::string(stack_.data() + old_top, stack_.size() - old_top);
-        stack_.resize(old_top);
-        type_ = Type::kString;
-        return Ret::kParseOk;
+    DiyFp normalize() const {
+        int lz = clz64(f);
+        return {f << lz, e - lz};
     }
+};
 
-    Ret parse_array(const char *&text) {
-        ++text;
-        parse_whitespace(text);
-        if (!*text) {
-            return Ret::kParseMissCommaOrSquareBracket;
-        } else if (*text == ']') {
-            ++text;
-            value_.array = new Array();
-            type_ = Type::kArray;
-            return Ret::kParseOk;
-        }
+// 10^k 的 64 位近似, k = -300, -292, ..., 340
+struct CachedPower {
+    uint64_t f;
+    int e;
+    int k;
+};
 
-        Array array;
-        for (;;) {
-            Json value;
-            Ret ret = value.parse_text(text);
-            if (ret != Ret::kParseOk) return ret;
-            array.emplace_back(std::move(value));
+inline CachedPower cached_power(int e) {
+    static const CachedPower kCachedPowers[] = {
+        {0xAB70FE17C79AC6CA, -1060, -300},
+        {0xFF77B1FCBEBCDC4F, -1034, -292},
+        {0xBE5691EF416BD60C, -1007, -284},
+        {0x8DD01FAD907FFC3C,  -980, -276},
+        {0xD3515C2831559A83,  -954, -268},
+        {0x9D71AC8FADA6C9B5,  -927, -260},
+        {0xEA9C227723EE8BCB,  -901, -252},
+        {0xAECC49914078536D,  -874, -244},
+        {0x823C12795DB6CE57,  -847, -236},
+        {0xC21094364DFB5637,  -821, -228},
+        {0x9096EA6F3848984F,  -794, -220},
+        {0xD77485CB25823AC7,  -768, -212},
+        {0xA086CFCD97BF97F4,  -741, -204},
+        {0xEF340A98172AACE5,  -715, -196},
+        {0xB23867FB2A35B28E,  -688, -188},
+        {0x84C8D4DFD2C63F3B,  -661, -180},
+        {0xC5DD44271AD3CDBA,  -635, -172},
+        {0x936B9FCEBB25C996,  -608, -164},
+        {0xDBAC6C247D62A584,  -582, -156},
+        {0xA3AB66580D5FDAF6,  -555, -148},
+        {0xF3E2F893DEC3F126,  -529, -140},
+        {0xB5B5ADA8AAFF80B8,  -502, -132},
+        {0x87625F056C7C4A8B,  -475, -124},
+        {0xC9BCFF6034C13053,  -449, -116},
+        {0x964E858C91BA2655,  -422, -108},
+        {0xDFF9772470297EBD,  -396, -100},
+        {0xA6DFBD9FB8E5B88F,  -369,  -92},
+        {0xF8A95FCF88747D94,  -343,  -84},
+        {0xB94470938FA89BCF,  -316,  -76},
+        {0x8A08F0F8BF0F156B,  -289,  -68},
+        {0xCDB02555653131B6,  -263,  -60},
+        {0x993FE2C6D07B7FAC,  -236,  -52},
+        {0xE45C10C42A2B3B06,  -210,  -44},
+        {0xAA242499697392D3,  -183,  -36},
+        {0xFD87B5F28300CA0E,  -157,  -28},
+        {0xBCE5086492111AEB,  -130,  -20},
+        {0x8CBCCC096F5088CC,  -103,  -12},
+        {0xD1B71758E219652C,   -77,   -4},
+        {0x9C40000000000000,   -50,    4},
+        {0xE8D4A51000000000,   -24,   12},
+        {0xAD78EBC5AC620000,     3,   20},
+        {0x813F3978F8940984,    30,   28},
+        {0xC097CE7BC90715B3,    56,   36},
+        {0x8F7E32CE7BEA5C70,    83,   44},
+        {0xD5D238A4ABE98068,   109,   52},
+        {0x9F4F2726179A2245,   136,   60},
+        {0xED63A231D4C4FB27,   162,   68},
+        {0xB0DE65388CC8ADA8,   189,   76},
+        {0x83C7088E1AAB65DB,   216,   84},
+        {0xC45D1DF942711D9A,   242,   92},
+        {0x924D692CA61BE758,   269,  100},
+        {0xDA01EE641A708DEA,   295,  108},
+        {0xA26DA3999AEF774A,   322,  116},
+        {0xF209787BB47D6B85,   348,  124},
+        {0xB454E4A179DD1877,   375,  132},
+        {0x865B86925B9BC5C2,   402,  140},
+        {0xC83553C5C8965D3D,   428,  148},
+        {0x952AB45CFA97A0B3,   455,  156},
+        {0xDE469FBD99A05FE3,   481,  164},
+        {0xA59BC234DB398C25,   508,  172},
+        {0xF6C69A72A3989F5C,   534,  180},
+        {0xB7DCBF5354E9BECE,   561,  188},
+        {0x88FCF317F22241E2,   588,  196},
+        {0xCC20CE9BD35C78A5,   614,  204},
+        {0x98165AF37B2153DF,   641,  212},
+        {0xE2A0B5DC971F303A,   667,  220},
+        {0xA8D9D1535CE3B396,   694,  228},
+        {0xFB9B7CD9A4A7443C,   720,  236},
+        {0xBB764C4CA7A44410,   747,  244},
+        {0x8BAB8EEFB6409C1A,   774,  252},
+        {0xD01FEF10A657842C,   800,  260},
+        {0x9B10A4E5E9913129,   827,  268},
+        {0xE7109BFBA19C0C9D,   853,  276},
+        {0xAC2820D9623BF429,   880,  284},
+        {0x80444B5E7AA7CF85,   907,  292},
+        {0xBF21E44003ACDD2D,   933,  300},
+        {0x8E679C2F5E44FF8F,   960,  308},
+        {0xD433179D9C8CB841,   986,  316},
+        {0x9E19DB92B4E31BA9,  1013,  324},
+        {0xEB96BF6EBADF77D9,  1039,  332},
+        {0xAF87023B9BF0EE6B,  1066,  340},
+    };
+    // 选取 k 使 c = 10^-k 满足 alpha <= e_c + e + 64 <= gamma
+    const int kAlpha = -60;
+    int f = kAlpha - e - 1;
+    int k = (f * 78913) / (1 << 18) + (f > 0);
+    return kCachedPowers[(300 + k + 7) / 8];
+}
 
-            parse_whitespace(text);
-            if (*text == ']') {
-                ++text;
-                break;
-            } else if (*text != ',') {
-                return Ret::kParseMissCommaOrSquareBracket;
-            }
-            ++text;
-        }
-        value_.array = new Array(std::move(array));
-        type_ = Type::kArray;
-        return Ret::kParseOk;
-    }
+inline int largest_pow10(uint32_t n, uint32_t &pow10) {
+    static const uint32_t kPow10[] = {1,         10,        100,     1000,
+                                      10000,     100000,    1000000, 10000000,
+                                      100000000, 1000000000};
+    int k = 9;
+    while (k > 0 && n < kPow10[k]) --k;
+    pow10 = kPow10[k];
+    return k + 1;
+}
 
-    Ret parse_object(const char *&text) {
-        ++text;
-        parse_whitespace(text);
-        if (!*text) {
-            return Ret::kParseMissCommaOrCurlyBracket;
-        } else if (*text == '}') {
-            ++text;
-            value_.object = new Object();
-            type_ = Type::kObject;
-            return Ret::kParseOk;
-        }
+inline void grisu2_round(char *buf, int len, uint64_t dist, uint64_t delta,
+                         uint64_t rest, uint64_t ten_k) {
+    while (rest < dist && delta - rest >= ten_k &&
+           (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+        --buf[len - 1];
+        rest += ten_k;
+    }
+}
 
-        Object object;
-        for (;;) {
-            int old_top = stack_.size();
-            if (*text != '\"' || parse_string_raw(text) != Ret::kParseOk) {
-                return Ret::kParseMissKey;
-            }
-            parse_whitespace(text);
-            if (*text++ != ':') return Ret::kParseMissColon;
+// 在 (m_minus, m_plus) 区间内生成尽量短的数字串, 输出 buf[0, len) * 10^exp10
+inline void grisu2(double value, char *buf, int &len, int &exp10) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint64_t fraction = bits & ((uint64_t(1) << kMantissaBits) - 1);
+    int biased = int(bits >> kMantissaBits & 0x7FF);
 
-            std::string key(stack_.data() + old_top, stack_.size() - old_top);
-            stack_.resize(old_top);
+    DiyFp v{fraction, -1074};
+    if (biased != 0) {
+        v = {fraction | uint64_t(1) << kMantissaBits, biased - 1075};
+    }
+    // 与相邻 double 的中点; 尾数为 0 时下侧间距减半
+    DiyFp m_plus = DiyFp{2 * v.f + 1, v.e - 1}.normalize();
+    DiyFp m_minus = fraction == 0 && biased > 1 ? DiyFp{4 * v.f - 1, v.e - 2}
+                                                : DiyFp{2 * v.f - 1, v.e - 1};
+    m_minus = {m_minus.f << (m_minus.e - m_plus.e), m_plus.e};
 
-            Json value;
-            Ret ret = value.parse_text(text);
-            if (ret != Ret::kParseOk) return ret;
+    CachedPower cached = cached_power(m_plus.e);
+    DiyFp c{cached.f, cached.e};
+    DiyFp w = v.normalize() * c;
+    DiyFp w_minus = m_minus * c, w_plus = m_plus * c;
+    w_minus.f += 1;
+    w_plus.f -= 1;
 
-            object.emplace(std::move(key), std::move(value));
+    uint64_t delta = (w_plus - w_minus).f;
+    uint64_t dist = (w_plus - w).f;
+    DiyFp one{uint64_t(1) << -w_plus.e, w_plus.e};
+    uint32_t p1 = uint32_t(w_plus.f >> -one.e);
+    uint64_t p2 = w_plus.f & (one.f - 1);
 
-            parse_whitespace(text);
-            if (*text == '}') {
-                ++text;
-                break;
-            } else if (*text != ',') {
-                return Ret::kParseMissCommaOrCurlyBracket;
-            }
-            ++text;
-            parse_whitespace(text);
+    len = 0;
+    exp10 = -cached.k;
+    uint32_t pow10;
+    int n = largest_pow10(p1, pow10);
+    while (n > 0) {
+        buf[len++] = char('0' + p1 / pow10);
+        p1 %= pow10;
+        --n;
+        uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+        if (rest <= delta) {
+            exp10 += n;
+            uint64_t ten_k = uint64_t(pow10) << -one.e;
+            grisu2_round(buf, len, dist, delta, rest, ten_k);
+            return;
         }
+        pow10 /= 10;
+    }
+    for (;;) {
+        p2 *= 10;
+        buf[len++] = char('0' + (p2 >> -one.e));
+        p2 &= one.f - 1;
+        --exp10;
+        delta *= 10;
+        dist *= 10;
+        if (p2 <= delta) break;
+    }
+    grisu2_round(buf, len, dist, delta, p2, one.f);
+}
 
-        value_.object = new Object(std::move(object));
-        type_ = Type::kObject;
-        return Ret::kParseOk;
+// 写出能精确读回 value 的最短十进制表示, 返回结尾位置. 格式与 %.17g 一致:
+// 小数点位置在 [-3, 17] 内用定点表示, 否则用科学计数法
+inline char *format_double(char *out, double value) {
+    if (std::isnan(value)) return (char *)memcpy(out, "nan", 3) + 3;
+    if (std::signbit(value)) {
+        *out++ = '-';
+        value = -value;
+    }
+    if (std::isinf(value)) return (char *)memcpy(out, "inf", 3) + 3;
+    // 能精确表示的整数直接按整数输出
+    if (value < 0x1p53 && value == double(uint64_t(value))) {
+        return std::to_chars(out, out + 20, uint64_t(value)).ptr;
     }
 
-    char *str_dup(const char *str, size_t len) {
-        char *text = (char *)malloc(len + 1);
-        memcpy(text, str, len);
-        text[len] = '\0';
-        return text;
+    char digits[20];
+    int len, exp10;
+    grisu2(value, digits, len, exp10);
+    int point = len + exp10;  // value = 0.digits * 10^point
+
+    if (point >= len && point <= 17) {
+        memcpy(out, digits, len);
+        memset(out + len, '0', point - len);
+        return out + point;
+    } else if (point > 0 && point <= 17) {
+        memcpy(out, digits, point);
+        out[point] = '.';
+        memcpy(out + point + 1, digits + point, len - point);
+        return out + len + 1;
+    } else if (point > -4 && point <= 0) {
+        out[0] = '0';
+        out[1] = '.';
+        memset(out + 2, '0', -point);
+        memcpy(out + 2 - point, digits, len);
+        return out + 2 - point + len;
     }
 
-    char *stringify_number() {
-        char buf[32];
-        int len = sprintf(buf, "%.17g", value_.number);
-        return str_dup(buf, len);
+    *out++ = digits[0];
+    if (len > 1) {
+        *out++ = '.';
+        memcpy(out, digits + 1, len - 1);
+        out += len - 1;
     }
+    int e = point - 1;
+    *out++ = 'e';
+    *out++ = e < 0 ? '-' : '+';
+    if (e < 0) e = -e;
+    if (e < 10) *out++ = '0';
+    return std::to_chars(out, out + 3, e).ptr;
+}
 
-    void stringify_hex4(int code) {
-        char buf[5];
+// ---- arena ----
+
+// 单调增长的内存池: 按块向系统申请, 块内顺序切分, 不单独释放, 析构时整体归还.
+// 给定 upstream 时块改从 upstream 申请
+class Arena {
+public:
+    Arena() = default;
+    explicit Arena(std::pmr::memory_resource *upstream) : upstream_(upstream) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { release(head_); }
+
+    void *allocate(size_t size, size_t align) {
+        uintptr_t p = (uintptr_t(cur_) + align - 1) & ~uintptr_t(align - 1);
+        if (!cur_ || p + size > uintptr_t(end_)) {
+            grow(size + align);
+            p = (uintptr_t(cur_) + align - 1) & ~uintptr_t(align - 1);
+        }
+        cur_ = (char *)(p + size);
+        return (void *)p;
+    }
+
+    // 清空内容, 只留下最近的一块供下次复用
+    void reset() {
+        if (!head_) return;
+        release(head_->next);
+        head_->next = nullptr;
+        cur_ = (char *)(head_ + 1);
+    }
+
+private:
+    struct Block {
+        Block *next;
+        size_t size;
+    };
+
+    static constexpr size_t kMinBlockSize = 4096;
+    static constexpr size_t kMaxBlockSize = 1 << 20;
+
+    void grow(size_t min_size) {
+        size_t size = std::max(next_size_, min_size + sizeof(Block));
+        next_size_ = std::min(next_size_ * 2, kMaxBlockSize);
+        Block *block;
+        if (upstream_) {
+            block = (Block *)upstream_->allocate(size,
+                                                 alignof(std::max_align_t));
+        } else {
+            block = (Block *)malloc(size);
+            if (!block) ZJSON_THROW(std::bad_alloc());
+        }
+        block->next = head_;
+        block->size = size;
+        head_ = block;
+        cur_ = (char *)(block + 1);
+        end_ = (char *)block + size;
+    }
+
+    void release(Block *block) {
+        while (block) {
+            Block *next = block->next;
+            if (upstream_) {
+                upstream_->deallocate(block, block->size,
+                                      alignof(std::max_align_t));
+            } else {
+                free(block);
+            }
+            block = next;
+        }
+    }
+
+    std::pmr::memory_resource *upstream_ = nullptr;
+    Block *head_ = nullptr;
+    char *cur_ = nullptr;
+    char *end_ = nullptr;
+    size_t next_size_ = kMinBlockSize;
+};
+
+// 容器用的分配器: 绑定 arena 时从 arena 分配且不释放, 否则交给无状态的堆分配器
+// Heap (按需 rebind). 拷贝容器时总是换回堆, 拷贝出的值与原 arena 无关
+template <typename T, typename Heap = std::allocator<T>>
+class Allocator {
+public:
+    using value_type = T;
+    using HeapAllocator =
+        typename std::allocator_traits<Heap>::template rebind_alloc<T>;
+
+    template <typename U>
+    struct rebind {
+        using other = Allocator<U, Heap>;
+    };
+
+    Allocator() noexcept = default;
+    explicit Allocator(Arena *arena) noexcept : arena_(arena) {}
+    template <typename U>
+    Allocator(const Allocator<U, Heap> &other) noexcept
+        : arena_(other.arena()) {}
+
+    T *allocate(size_t n) {
+        if (arena_) return (T *)arena_->allocate(n * sizeof(T), alignof(T));
+        HeapAllocator heap;
+        return std::allocator_traits<HeapAllocator>::allocate(heap, n);
+    }
+
+    void deallocate(T *p, size_t n) {
+        if (arena_) return;
+        HeapAllocator heap;
+        std::allocator_traits<HeapAllocator>::deallocate(heap, p, n);
+    }
+
+    Allocator select_on_container_copy_construction() const {
+        return Allocator();
+    }
+
+    Arena *arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const Allocator<U, Heap> &other) const {
+        return arena_ == other.arena();
+    }
+    template <typename U>
+    bool operator!=(const Allocator<U, Heap> &other) const {
+        return arena_ != other.arena();
+    }
+
+private:
+    Arena *arena_ = nullptr;
+};
+
+// ---- memory_resource ----
+
+// 当前线程由 ResourceScope 指定的 resource, 未指定时为空
+inline std::pmr::memory_resource *&scoped_resource() {
+    static thread_local std::pmr::memory_resource *resource = nullptr;
+    return resource;
+}
+
+inline std::pmr::memory_resource *current_resource() {
+    std::pmr::memory_resource *resource = scoped_resource();
+    return resource ? resource : std::pmr::get_default_resource();
+}
+
+// 从当前线程的 resource 分配的无状态分配器. 每块内存前记下它来自哪个
+// resource, 释放时归还原处, 所以在哪个线程, 哪个作用域中释放都不会出错
+template <typename T>
+class ResourceAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    ResourceAllocator() noexcept = default;
+    template <typename U>
+    ResourceAllocator(const ResourceAllocator<U> &) noexcept {}
+
+    T *allocate(size_t n) {
+        if (n > (SIZE_MAX - header()) / sizeof(T)) {
+            ZJSON_THROW(std::bad_array_new_length());
+        }
+        std::pmr::memory_resource *resource = current_resource();
+        char *base =
+            (char *)resource->allocate(header() + n * sizeof(T), align());
+        memcpy(base, &resource, sizeof(resource));
+        return (T *)(base + header());
+    }
+
+    void deallocate(T *p, size_t n) noexcept {
+        char *base = (char *)p - header();
+        std::pmr::memory_resource *resource;
+        memcpy(&resource, base, sizeof(resource));
+        resource->deallocate(base, header() + n * sizeof(T), align());
+    }
+
+    template <typename U>
+    bool operator==(const ResourceAllocator<U> &) const {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const ResourceAllocator<U> &) const {
+        return false;
+    }
+
+private:
+    using Resource = std::pmr::memory_resource *;
+
+    static constexpr size_t align() {
+        return std::max(alignof(T), alignof(Resource));
+    }
+    // 头部放 resource 指针, 并保持其后 T 的对齐
+    static constexpr size_t header() {
+        return (sizeof(Resource) + align() - 1) / align() * align();
+    }
+};
+
+// valueOr 的返回类型: 字符串字面量按 std::string_view 取出, 其余与
+// fallback 相同
+template <typename T>
+using OrValue =
+    typename std::conditional<std::is_same<T, const char *>::value ||
+                                  std::is_same<T, char *>::value,
+                              std::string_view, T>::type;
+
+// 带引用计数的容器载荷. 堆上的 Array/Object 在拷贝节点时只增加计数, 由各副本
+// 共享, 修改前仍被共享才复制一份 (copy-on-write). arena 中的载荷不计数.
+// refs 为 0 表示载荷已交出过可变的引用或迭代器, 只属于一个节点, 不再共享
+template <typename T>
+struct Shared {
+    template <typename... Args>
+    explicit Shared(Args &&...args) : value(std::forward<Args>(args)...) {}
+    Shared(const Shared &) = delete;
+    Shared &operator=(const Shared &) = delete;
+
+    T value;
+    std::atomic<uint32_t> refs{1};
+};
+
+}  // namespace detail
+
+using detail::ResourceAllocator;
+
+// 作用域内当前线程经 ResourceAllocator 新建的载荷 (PmrJson 的字符串, 容器,
+// 超过内联长度的键等) 都从 resource 分配. 可以嵌套, 析构时恢复外层的设置.
+// resource 需比从中分配的值活得久
+class ResourceScope {
+public:
+    explicit ResourceScope(std::pmr::memory_resource *resource)
+        : saved_(detail::scoped_resource()) {
+        detail::scoped_resource() = resource;
+    }
+    ResourceScope(const ResourceScope &) = delete;
+    ResourceScope &operator=(const ResourceScope &) = delete;
+    ~ResourceScope() { detail::scoped_resource() = saved_; }
+
+private:
+    std::pmr::memory_resource *saved_;
+};
+
+template <typename Traits>
+class BasicJson;
+
+// 对象的键, 16 字节. 自有的键不超过 14 字节时内联存放, 否则经 Alloc (所在
+// Json 的 Traits::Allocator<char>) 分配, 因此只有 PmrJson 的键会放在
+// ResourceScope 的 resource 上; 原地解析的键只引用输入缓冲区; Document 中的键
+// 引用其键表, 相同的键只存一份, 两个这样的键相等当且仅当指针相同
+template <typename Alloc>
+class BasicKey {
+    using Key = BasicKey;
+
+public:
+    BasicKey() = default;
+    BasicKey(const char *str) : BasicKey(std::string_view(str)) {}
+    BasicKey(const std::string &str) : BasicKey(std::string_view(str)) {}
+    BasicKey(std::string_view sv) { assign(sv); }
+
+    // 不拷贝内容, sv 指向的内存需比 Key 活得久
+    static Key view(std::string_view sv) { return Key(sv, kView); }
+
+    // 引用键表的键在拷贝时转为自有内存, 拷贝不依赖 Document
+    BasicKey(const Key &other) {
+        if (other.storage_ == kView) {
+            *this = view(other);
+        } else {
+            assign(other);
+        }
+    }
+
+    BasicKey(Key &&other) noexcept {
+        memcpy(this, &other, sizeof(Key));
+        other.storage_ = kInline;
+        other.length_ = 0;
+    }
+
+    Key &operator=(const Key &other) { return *this = Key(other); }
+
+    Key &operator=(Key &&other) noexcept {
+        if (this != &other) {
+            release();
+            memcpy(this, &other, sizeof(Key));
+            other.storage_ = kInline;
+            other.length_ = 0;
+        }
+        return *this;
+    }
+
+    ~BasicKey() { release(); }
+
+    bool isView() const { return storage_ == kView; }
+    bool isInterned() const { return storage_ == kInterned; }
+
+    const char *data() const {
+        if (storage_ == kInline) return buf_;
+        const char *p;
+        memcpy(&p, buf_, sizeof(p));
+        return p;
+    }
+
+    size_t size() const {
+        if (storage_ == kInline) return length_;
+        uint32_t n;
+        memcpy(&n, buf_ + sizeof(const char *), sizeof(n));
+        return n;
+    }
+
+    std::string str() const { return std::string(data(), size()); }
+
+    operator std::string_view() const { return {data(), size()}; }
+
+    friend bool operator<(const Key &a, const Key &b) {
+        return std::string_view(a) < std::string_view(b);
+    }
+    friend bool operator==(const Key &a, const Key &b) {
+        if (a.storage_ == kInterned && b.storage_ == kInterned) {
+            return a.data() == b.data();
+        }
+        return std::string_view(a) == std::string_view(b);
+    }
+
+private:
+    template <typename Traits>
+    friend class BasicJson;
+
+    enum Storage : uint8_t { kInline, kHeap, kView, kInterned };
+
+    static constexpr size_t kInlineCapacity = 14;
+
+    BasicKey(std::string_view sv, Storage storage) { set_ref(sv, storage); }
+
+    // sv 是 Document 键表中的键
+    static Key interned(std::string_view sv) { return Key(sv, kInterned); }
+
+    void assign(std::string_view sv) {
+        if (sv.size() <= kInlineCapacity) {
+            memcpy(buf_, sv.data(), sv.size());
+            length_ = uint8_t(sv.size());
+            storage_ = kInline;
+            return;
+        }
+        if (sv.size() > UINT32_MAX) {
+            ZJSON_THROW(std::length_error("key too long!"));
+        }
+        Alloc alloc;
+        char *p = std::allocator_traits<Alloc>::allocate(alloc, sv.size());
+        memcpy(p, sv.data(), sv.size());
+        set_ref({p, sv.size()}, kHeap);
+    }
+
+    // 指针和长度存在 buf_ 的前 12 字节
+    void set_ref(std::string_view sv, Storage storage) {
+        if (sv.size() > UINT32_MAX) {
+            ZJSON_THROW(std::length_error("key too long!"));
+        }
+        const char *p = sv.data();
+        uint32_t n = uint32_t(sv.size());
+        memcpy(buf_, &p, sizeof(p));
+        memcpy(buf_ + sizeof(p), &n, sizeof(n));
+        storage_ = storage;
+    }
+
+    void release() {
+        if (storage_ == kHeap) {
+            Alloc alloc;
+            std::allocator_traits<Alloc>::deallocate(
+                alloc, const_cast<char *>(data()), size());
+        }
+    }
+
+    char buf_[kInlineCapacity];
+    uint8_t length_ = 0;  // 内联时的长度
+    Storage storage_ = kInline;
+};
+
+// Json 的键
+using Key = BasicKey<std::allocator<char>>;
+
+static_assert(sizeof(Key) == 16, "Key should stay 16 bytes");
+
+namespace detail {
+
+// 对象容器的键类型. 键不放在 arena 中, 总是用 Allocator 包装的堆分配器
+template <typename Alloc>
+struct KeyAllocator {
+    using type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<char>;
+};
+
+template <typename T, typename Heap>
+struct KeyAllocator<Allocator<T, Heap>> {
+    using type =
+        typename std::allocator_traits<Heap>::template rebind_alloc<char>;
+};
+
+template <typename Alloc>
+using ObjectKey = BasicKey<typename KeyAllocator<Alloc>::type>;
+
+// 键表: 每个不同的键只在自带的 arena 中存一份, 返回的视图在 clear() 前有效.
+// 线性探测的开放寻址哈希表, 负载因子不超过 1/2
+class KeyTable {
+public:
+    KeyTable() = default;
+    explicit KeyTable(std::pmr::memory_resource *upstream)
+        : arena_(upstream), slots_(upstream) {}
+
+    std::string_view intern(std::string_view key) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            rehash(std::max<size_t>(slots_.size() * 2, 64));
+        }
+        size_t mask = slots_.size() - 1;
+        size_t idx = std::hash<std::string_view>()(key) & mask;
+        for (; slots_[idx].data(); idx = (idx + 1) & mask) {
+            if (slots_[idx] == key) return slots_[idx];
+        }
+        // 空键也要有非空指针, 与空槽区分
+        char *data = (char *)arena_.allocate(key.size() + 1, 1);
+        memcpy(data, key.data(), key.size());
+        slots_[idx] = {data, key.size()};
+        ++size_;
+        bytes_ += key.size() + 1;
+        return slots_[idx];
+    }
+
+    size_t size() const { return size_; }
+    // 键本身占用的字节数, 不含槽位数组
+    size_t bytes() const { return bytes_; }
+
+    void clear() {
+        arena_.reset();
+        slots_.clear();
+        size_ = 0;
+        bytes_ = 0;
+    }
+
+private:
+    void rehash(size_t capacity) {
+        std::pmr::vector<std::string_view> slots(capacity,
+                                                 slots_.get_allocator());
+        slots.swap(slots_);
+        size_t mask = capacity - 1;
+        for (std::string_view key : slots) {
+            if (!key.data()) continue;
+            size_t idx = std::hash<std::string_view>()(key) & mask;
+            while (slots_[idx].data()) idx = (idx + 1) & mask;
+            slots_[idx] = key;
+        }
+    }
+
+    Arena arena_;
+    std::pmr::vector<std::string_view> slots_;
+    size_t size_ = 0;
+    size_t bytes_ = 0;
+};
+
+}  // namespace detail
+
+// ---- 对象容器 ----
+// 各容器提供同一组接口 (find/at/operator[]/emplace/erase/迭代), 由编译选项
+// 选定 Json::Object. 解析时逐个 append 成员, 对象闭合时调用一次 seal().
+// 重复的键都只保留第一个
+
+// 预先算好哈希的键, 同一个键反复查找时省去每次的哈希.
+// hash 须为 std::hash<std::string_view>()(key); key 指向的内存由调用方保证有效
+struct HashedKey {
+    explicit HashedKey(std::string_view key)
+        : key(key), hash(std::hash<std::string_view>()(key)) {}
+    HashedKey(std::string_view key, size_t hash) : key(key), hash(hash) {}
+
+    std::string_view key;
+    size_t hash;
+};
+
+namespace detail {
+
+// 对象成员的迭代器. 成员按 std::pair<Key, T> 存放, 便于容器内部移动和排序;
+// 对外的键只读, 不能经迭代器改写键而打乱容器的顺序或索引. 解引用得到
+// std::pair<const Key &, T &>, 用 it->first/it->second 或 auto &&[key, value]
+// 访问
+template <typename Base>
+class ConstKeyIterator {
+    using Item = typename std::remove_reference<
+        typename std::iterator_traits<Base>::reference>::type;
+    using Mapped = typename std::conditional<
+        std::is_const<Item>::value, const typename Item::second_type,
+        typename Item::second_type>::type;
+    using Key = typename Item::first_type;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<const Key, typename Item::second_type>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const Key &, Mapped &>;
+
+    class pointer {
+    public:
+        const reference *operator->() const { return &ref_; }
+
+    private:
+        friend class ConstKeyIterator;
+        explicit pointer(reference ref) : ref_(ref) {}
+        reference ref_;
+    };
+
+    ConstKeyIterator() = default;
+    explicit ConstKeyIterator(Base it) : it_(it) {}
+    // iterator 可以转为 const_iterator
+    template <typename Other,
+              typename std::enable_if<std::is_convertible<Other, Base>::value &&
+                                          !std::is_same<Other, Base>::value,
+                                      int>::type = 0>
+    ConstKeyIterator(const ConstKeyIterator<Other> &other)
+        : it_(other.base()) {}
+
+    reference operator*() const { return {it_->first, it_->second}; }
+    pointer operator->() const { return pointer(**this); }
+
+    ConstKeyIterator &operator++() {
+        ++it_;
+        return *this;
+    }
+
+    ConstKeyIterator operator++(int) {
+        ConstKeyIterator it = *this;
+        ++it_;
+        return it;
+    }
+
+    bool operator==(const ConstKeyIterator &other) const {
+        return it_ == other.it_;
+    }
+    bool operator!=(const ConstKeyIterator &other) const {
+        return it_ != other.it_;
+    }
+
+    const Base &base() const { return it_; }
+
+private:
+    Base it_{};
+};
+
+// 默认: 按插入顺序存放成员的连续数组, dump 时保持原有的键序. 成员不多时线性
+// 查找; 超过 kIndexThreshold 个时建立哈希索引, 之后插入和删除时随之维护.
+// 查找不修改容器, 对同一对象的只读查找可以并发
+template <typename T, typename Alloc>
+class OrderedMap {
+    using Key = ObjectKey<Alloc>;
+    using Item = std::pair<Key, T>;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using allocator_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Item>;
+    using iterator = ConstKeyIterator<
+        typename std::vector<Item, allocator_type>::iterator>;
+    using const_iterator = ConstKeyIterator<
+        typename std::vector<Item, allocator_type>::const_iterator>;
+
+    static constexpr size_t kIndexThreshold = 16;
+
+    OrderedMap() = default;
+    explicit OrderedMap(const allocator_type &alloc)
+        : items_(alloc), index_(IndexAllocator(alloc)) {}
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+    iterator begin() { return iterator(items_.begin()); }
+    iterator end() { return iterator(items_.end()); }
+    const_iterator begin() const { return const_iterator(items_.begin()); }
+    const_iterator end() const { return const_iterator(items_.end()); }
+
+    iterator find(std::string_view key) { return at_index(locate(key)); }
+
+    const_iterator find(std::string_view key) const {
+        return at_index(locate(key));
+    }
+
+    iterator find(const HashedKey &key) { return at_index(locate(key)); }
+
+    const_iterator find(const HashedKey &key) const {
+        return at_index(locate(key));
+    }
+
+    T &at(std::string_view key) {
+        return const_cast<T &>(std::as_const(*this).at(key));
+    }
+
+    const T &at(std::string_view key) const {
+        size_t idx = locate(key);
+        if (idx == kNotFound) ZJSON_THROW(std::out_of_range("key not found!"));
+        return items_[idx].second;
+    }
+
+    T &operator[](std::string_view key) {
+        size_t idx = locate(key);
+        if (idx == kNotFound) idx = push(Key(key), T());
+        return items_[idx].second;
+    }
+
+    std::pair<iterator, bool> emplace(Key key, T value) {
+        size_t idx = locate(key);
+        if (idx != kNotFound) return {at_index(idx), false};
+        idx = push(std::move(key), std::move(value));
+        return {at_index(idx), true};
+    }
+
+    // 保持其余成员的顺序: 其后的成员前移一位. 索引不重建, 只删去被删成员的
+    // 槽位并把后面成员的下标减一; 后面的成员少时逐个按哈希找到槽位, 多时
+    // 直接扫一遍槽位数组, 都不必重新计算其余的键
+    size_t erase(std::string_view key) {
+        size_t idx = locate(key);
+        if (idx == kNotFound) return 0;
+        if (!index_.empty()) unindex(idx);
+        items_.erase(items_.begin() + idx);
+        if (items_.size() <= kIndexThreshold) {
+            index_.clear();
+        } else if (index_.empty()) {
+            build_index();
+        } else if ((items_.size() - idx) * 16 < index_.size()) {
+            for (size_t i = idx; i < items_.size(); ++i) {
+                index_[slot_of(i, i + 2)] = uint32_t(i + 1);
+            }
+        } else {
+            for (uint32_t &slot : index_) slot -= slot > idx + 1;
+        }
+        return 1;
+    }
+
+    void append(Key &&key, T &&value) {
+        items_.emplace_back(std::move(key), std::move(value));
+        index_back();
+    }
+
+    // 去掉重复的键. 小对象两两比较; 大对象在追加时已随索引检查过,
+    // 有重复时索引被丢弃, 这里重建索引并去重
+    void seal() {
+        if (items_.size() <= kIndexThreshold) {
+            for (size_t i = 1; i < items_.size(); ++i) {
+                for (size_t j = 0; j < i; ++j) {
+                    if (items_[j].first == items_[i].first) {
+                        items_.erase(items_.begin() + i--);
+                        break;
+                    }
+                }
+            }
+            return;
+        }
+        if (!index_.empty()) return;
+        reset_index();
+        size_t n = 0;
+        for (size_t i = 0; i < items_.size(); ++i) {
+            if (n != i) items_[n] = std::move(items_[i]);
+            if (insert_index(n)) ++n;
+        }
+        items_.erase(items_.begin() + n, items_.end());
+    }
+
+private:
+    using IndexAllocator = typename std::allocator_traits<
+        Alloc>::template rebind_alloc<uint32_t>;
+
+    static constexpr size_t kNotFound = size_t(-1);
+
+    iterator at_index(size_t idx) {
+        return idx == kNotFound ? end() : iterator(items_.begin() + idx);
+    }
+
+    const_iterator at_index(size_t idx) const {
+        return const_cast<OrderedMap *>(this)->at_index(idx);
+    }
+
+    static size_t hash(std::string_view key) {
+        return std::hash<std::string_view>()(key);
+    }
+
+    // 没有索引的是小对象, 或者是含重复键、还未 seal 的对象
+    size_t locate(std::string_view key) const {
+        if (index_.empty()) return scan(key);
+        return probe(key, hash(key));
+    }
+
+    size_t locate(const HashedKey &key) const {
+        if (index_.empty()) return scan(key.key);
+        return probe(key.key, key.hash);
+    }
+
+    size_t scan(std::string_view key) const {
+        for (size_t i = 0; i < items_.size(); ++i) {
+            const Key &k = items_[i].first;
+            if (k.size() == key.size() && std::string_view(k) == key) {
+                return i;
+            }
+        }
+        return kNotFound;
+    }
+
+    size_t probe(std::string_view key, size_t h) const {
+        size_t mask = index_.size() - 1;
+        for (size_t slot = h & mask;; slot = (slot + 1) & mask) {
+            if (index_[slot] == 0) return kNotFound;
+            if (std::string_view(items_[index_[slot] - 1].first) == key) {
+                return index_[slot] - 1;
+            }
+        }
+    }
+
+    size_t push(Key &&key, T &&value) {
+        items_.emplace_back(std::move(key), std::move(value));
+        index_back();
+        return items_.size() - 1;
+    }
+
+    // 把新追加的成员加入索引, 成员数刚超过 kIndexThreshold 时建立索引.
+    // 遇到重复的键 (只在解析途中出现) 就丢弃索引, 留给 seal 去重后重建
+    void index_back() {
+        size_t n = items_.size();
+        if (n == kIndexThreshold + 1) {
+            build_index();
+        } else if (!index_.empty()) {
+            if (n * 2 > index_.size()) {
+                build_index();
+            } else if (!insert_index(n - 1)) {
+                index_.clear();
+            }
+        }
+    }
+
+    // 槽位存成员下标 + 1, 0 表示空槽; 负载因子不超过 1/2.
+    // 键已在索引中时不插入, 返回 false
+    bool insert_index(size_t idx) {
+        std::string_view key = items_[idx].first;
+        size_t mask = index_.size() - 1;
+        size_t slot = hash(key) & mask;
+        for (; index_[slot] != 0; slot = (slot + 1) & mask) {
+            if (std::string_view(items_[index_[slot] - 1].first) == key) {
+                return false;
+            }
+        }
+        index_[slot] = uint32_t(idx + 1);
+        return true;
+    }
+
+    // 成员 idx 在索引中的槽位, 该槽中存的是 stored
+    size_t slot_of(size_t idx, size_t stored) const {
+        size_t mask = index_.size() - 1;
+        size_t slot = hash(items_[idx].first) & mask;
+        while (index_[slot] != stored) slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    // 从索引中删去成员 idx: 空出的槽位之后同一段中不在原位的槽依次前移,
+    // 使线性探测仍能找到它们
+    void unindex(size_t idx) {
+        size_t mask = index_.size() - 1;
+        size_t hole = slot_of(idx, idx + 1);
+        for (size_t slot = (hole + 1) & mask; index_[slot] != 0;
+             slot = (slot + 1) & mask) {
+            size_t home = hash(items_[index_[slot] - 1].first) & mask;
+            if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+                index_[hole] = index_[slot];
+                hole = slot;
+            }
+        }
+        index_[hole] = 0;
+    }
+
+    void reset_index() {
+        size_t capacity = 2 * kIndexThreshold;
+        while (capacity < items_.size() * 2) capacity *= 2;
+        index_.assign(capacity, 0);
+    }
+
+    // 有重复的键时不留索引
+    void build_index() {
+        reset_index();
+        for (size_t i = 0; i < items_.size(); ++i) {
+            if (!insert_index(i)) {
+                index_.clear();
+                return;
+            }
+        }
+    }
+
+    std::vector<Item, allocator_type> items_;
+    std::vector<uint32_t, IndexAllocator> index_;
+};
+
+// 透明的键比较: 可以直接用 std::string_view 查找, 不必先构造 Key
+struct KeyLess {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const {
+        return a < b;
+    }
+};
+
+// ZJSON_TREE_OBJECT: std::map, 按键排序, 每个成员一个树节点
+template <typename T, typename Alloc,
+          typename Base = std::map<
+              ObjectKey<Alloc>, T, KeyLess,
+              typename std::allocator_traits<Alloc>::template rebind_alloc<
+                  std::pair<const ObjectKey<Alloc>, T>>>>
+class TreeMap : public Base {
+    using Key = ObjectKey<Alloc>;
+
+public:
+    using Base::Base;
+
+    using Base::find;
+
+    auto find(const HashedKey &key) { return Base::find(key.key); }
+    auto find(const HashedKey &key) const { return Base::find(key.key); }
+
+    // std::map 的 at/operator[]/erase 只接受 Key, 这里改为按视图查找
+    T &at(std::string_view key) {
+        auto it = this->find(key);
+        if (it == this->end()) ZJSON_THROW(std::out_of_range("key not found!"));
+        return it->second;
+    }
+
+    const T &at(std::string_view key) const {
+        return const_cast<TreeMap *>(this)->at(key);
+    }
+
+    T &operator[](std::string_view key) {
+        auto it = this->lower_bound(key);
+        if (it == this->end() || std::string_view(it->first) != key) {
+            it = this->emplace_hint(it, Key(key), T());
+        }
+        return it->second;
+    }
+
+    size_t erase(std::string_view key) {
+        auto it = this->find(key);
+        if (it == this->end()) return 0;
+        Base::erase(it);
+        return 1;
+    }
+
+    void append(Key &&key, T &&value) {
+        this->emplace(std::move(key), std::move(value));
+    }
+
+    void seal() {}
+};
+
+// ZJSON_FLAT_OBJECT: 按键排序的连续数组, 二分查找. 适合成员不多的对象;
+// 解析时先按出现顺序追加, 闭合时再统一排序
+template <typename T, typename Alloc>
+class FlatMap {
+    using Key = ObjectKey<Alloc>;
+    using Item = std::pair<Key, T>;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using allocator_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Item>;
+    using iterator = ConstKeyIterator<
+        typename std::vector<Item, allocator_type>::iterator>;
+    using const_iterator = ConstKeyIterator<
+        typename std::vector<Item, allocator_type>::const_iterator>;
+
+    FlatMap() = default;
+    explicit FlatMap(const allocator_type &alloc) : items_(alloc) {}
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+    iterator begin() { return iterator(items_.begin()); }
+    iterator end() { return iterator(items_.end()); }
+    const_iterator begin() const { return const_iterator(items_.begin()); }
+    const_iterator end() const { return const_iterator(items_.end()); }
+
+    iterator find(std::string_view key) { return iterator(locate(key)); }
+
+    const_iterator find(std::string_view key) const {
+        return const_cast<FlatMap *>(this)->find(key);
+    }
+
+    iterator find(const HashedKey &key) { return find(key.key); }
+    const_iterator find(const HashedKey &key) const { return find(key.key); }
+
+    T &at(std::string_view key) {
+        auto it = locate(key);
+        if (it == items_.end()) {
+            ZJSON_THROW(std::out_of_range("key not found!"));
+        }
+        return it->second;
+    }
+
+    const T &at(std::string_view key) const {
+        return const_cast<FlatMap *>(this)->at(key);
+    }
+
+    T &operator[](std::string_view key) {
+        auto it = lower_bound(key);
+        if (it == items_.end() || std::string_view(it->first) != key) {
+            it = items_.emplace(it, Key(key), T());
+        }
+        return it->second;
+    }
+
+    std::pair<iterator, bool> emplace(Key key, T value) {
+        auto it = lower_bound(key);
+        if (it != items_.end() && it->first == key) {
+            return {iterator(it), false};
+        }
+        it = items_.emplace(it, std::move(key), std::move(value));
+        return {iterator(it), true};
+    }
+
+    size_t erase(std::string_view key) {
+        auto it = locate(key);
+        if (it == items_.end()) return 0;
+        items_.erase(it);
+        return 1;
+    }
+
+    void append(Key &&key, T &&value) {
+        items_.emplace_back(std::move(key), std::move(value));
+    }
+
+    // 稳定排序后去重, 相同的键保留先出现的
+    void seal() {
+        auto less = [](const Item &a, const Item &b) {
+            return a.first < b.first;
+        };
+        auto equal = [](const Item &a, const Item &b) {
+            return a.first == b.first;
+        };
+        if (std::is_sorted(items_.begin(), items_.end(), less) &&
+            std::adjacent_find(items_.begin(), items_.end(), equal) ==
+                items_.end()) {
+            return;
+        }
+        std::stable_sort(items_.begin(), items_.end(), less);
+        items_.erase(std::unique(items_.begin(), items_.end(), equal),
+                     items_.end());
+    }
+
+private:
+    using Items = std::vector<Item, allocator_type>;
+
+    typename Items::iterator lower_bound(std::string_view key) {
+        return std::lower_bound(items_.begin(), items_.end(), key,
+                                [](const Item &item, std::string_view k) {
+                                    return std::string_view(item.first) < k;
+                                });
+    }
+
+    typename Items::iterator locate(std::string_view key) {
+        auto it = lower_bound(key);
+        if (it != items_.end() && std::string_view(it->first) == key) {
+            return it;
+        }
+        return items_.end();
+    }
+
+    Items items_;
+};
+
+// ZJSON_HASH_OBJECT: 线性探测的开放寻址哈希表, 成员直接存在槽位数组中.
+// 适合成员很多的对象; 遍历按槽位顺序, 与键的顺序无关
+template <typename T, typename Alloc>
+class HashMap {
+    using Key = ObjectKey<Alloc>;
+    using Item = std::pair<Key, T>;
+
+    // 按槽位顺序遍历, 跳过空槽
+    template <typename V>
+    class SlotIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = V;
+        using difference_type = std::ptrdiff_t;
+        using pointer = V *;
+        using reference = V &;
+
+        SlotIterator() = default;
+        SlotIterator(V *slot, const uint32_t *hash, const uint32_t *last)
+            : slot_(slot), hash_(hash), last_(last) {
+            skip_empty();
+        }
+        template <typename U>
+        SlotIterator(const SlotIterator<U> &other)
+            : slot_(other.slot_), hash_(other.hash_), last_(other.last_) {}
+
+        V &operator*() const { return *slot_; }
+        V *operator->() const { return slot_; }
+
+        SlotIterator &operator++() {
+            ++slot_;
+            ++hash_;
+            skip_empty();
+            return *this;
+        }
+
+        SlotIterator operator++(int) {
+            SlotIterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const SlotIterator &other) const {
+            return slot_ == other.slot_;
+        }
+        bool operator!=(const SlotIterator &other) const {
+            return slot_ != other.slot_;
+        }
+
+    private:
+        template <typename U>
+        friend class SlotIterator;
+
+        void skip_empty() {
+            while (hash_ != last_ && *hash_ == 0) {
+                ++slot_;
+                ++hash_;
+            }
+        }
+
+        V *slot_ = nullptr;
+        const uint32_t *hash_ = nullptr;
+        const uint32_t *last_ = nullptr;
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using allocator_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Item>;
+    using iterator = ConstKeyIterator<SlotIterator<Item>>;
+    using const_iterator = ConstKeyIterator<SlotIterator<const Item>>;
+
+    HashMap() = default;
+    explicit HashMap(const allocator_type &alloc)
+        : slots_(alloc), hashes_(HashAllocator(alloc)) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    iterator begin() { return make_iterator(0); }
+    iterator end() { return make_iterator(slots_.size()); }
+    const_iterator begin() const { return make_iterator(0); }
+    const_iterator end() const { return make_iterator(slots_.size()); }
+
+    iterator find(std::string_view key) {
+        size_t idx = locate(key, hash(key));
+        return idx == kNotFound ? end() : make_iterator(idx);
+    }
+
+    const_iterator find(std::string_view key) const {
+        return const_cast<HashMap *>(this)->find(key);
+    }
+
+    iterator find(const HashedKey &key) {
+        size_t idx = locate(key.key, fold(key.hash));
+        return idx == kNotFound ? end() : make_iterator(idx);
+    }
+
+    const_iterator find(const HashedKey &key) const {
+        return const_cast<HashMap *>(this)->find(key);
+    }
+
+    T &at(std::string_view key) {
+        size_t idx = locate(key, hash(key));
+        if (idx == kNotFound) ZJSON_THROW(std::out_of_range("key not found!"));
+        return slots_[idx].second;
+    }
+
+    const T &at(std::string_view key) const {
+        return const_cast<HashMap *>(this)->at(key);
+    }
+
+    T &operator[](std::string_view key) {
+        return slots_[insert(Key(key), T()).first].second;
+    }
+
+    std::pair<iterator, bool> emplace(Key key, T value) {
+        auto [idx, inserted] = insert(std::move(key), std::move(value));
+        return {make_iterator(idx), inserted};
+    }
+
+    // 删除后把同一探测链上的后续成员前移, 不留墓碑
+    size_t erase(std::string_view key) {
+        size_t idx = locate(key, hash(key));
+        if (idx == kNotFound) return 0;
+        size_t mask = slots_.size() - 1;
+        for (size_t next = (idx + 1) & mask; hashes_[next] != 0;
+             next = (next + 1) & mask) {
+            size_t home = hashes_[next] & mask;
+            if (((next - home) & mask) >= ((next - idx) & mask)) {
+                slots_[idx] = std::move(slots_[next]);
+                hashes_[idx] = hashes_[next];
+                idx = next;
+            }
+        }
+        slots_[idx] = Item();
+        hashes_[idx] = 0;
+        --size_;
+        return 1;
+    }
+
+    void append(Key &&key, T &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    void seal() {}
+
+private:
+    using HashAllocator = typename std::allocator_traits<
+        Alloc>::template rebind_alloc<uint32_t>;
+
+    static constexpr size_t kNotFound = size_t(-1);
+    static constexpr size_t kMinCapacity = 8;
+
+    static uint32_t hash(std::string_view key) {
+        return fold(std::hash<std::string_view>()(key));
+    }
+
+    // 最高位恒为 1, 0 表示空槽
+    static uint32_t fold(size_t h) {
+        return uint32_t(h ^ (uint64_t(h) >> 32)) | 0x80000000;
+    }
+
+    iterator make_iterator(size_t idx) {
+        return iterator(SlotIterator<Item>(slots_.data() + idx,
+                                           hashes_.data() + idx,
+                                           hashes_.data() + hashes_.size()));
+    }
+
+    const_iterator make_iterator(size_t idx) const {
+        return const_cast<HashMap *>(this)->make_iterator(idx);
+    }
+
+    size_t locate(std::string_view key, uint32_t h) const {
+        if (slots_.empty()) return kNotFound;
+        size_t mask = slots_.size() - 1;
+        for (size_t idx = h & mask;; idx = (idx + 1) & mask) {
+            if (hashes_[idx] == 0) return kNotFound;
+            if (hashes_[idx] == h &&
+                std::string_view(slots_[idx].first) == key) {
+                return idx;
+            }
+        }
+    }
+
+    std::pair<size_t, bool> insert(Key &&key, T &&value) {
+        uint32_t h = hash(key);
+        size_t idx = locate(key, h);
+        if (idx != kNotFound) return {idx, false};
+        // 负载因子不超过 3/4
+        if ((size_ + 1) * 4 > slots_.size() * 3) {
+            rehash(std::max(slots_.size() * 2, kMinCapacity));
+        }
+        idx = place(h);
+        slots_[idx] = Item(std::move(key), std::move(value));
+        ++size_;
+        return {idx, true};
+    }
+
+    size_t place(uint32_t h) {
+        size_t mask = slots_.size() - 1;
+        size_t idx = h & mask;
+        while (hashes_[idx] != 0) idx = (idx + 1) & mask;
+        hashes_[idx] = h;
+        return idx;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Item, allocator_type> slots(capacity,
+                                               slots_.get_allocator());
+        std::vector<uint32_t, HashAllocator> hashes(capacity,
+                                                    hashes_.get_allocator());
+        slots.swap(slots_);
+        hashes.swap(hashes_);
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (hashes[i] != 0) slots_[place(hashes[i])] = std::move(slots[i]);
+        }
+    }
+
+    std::vector<Item, allocator_type> slots_;
+    std::vector<uint32_t, HashAllocator> hashes_;
+    size_t size_ = 0;
+};
+
+}  // namespace detail
+
+// 可供 JsonTraits::Object 选用的对象容器
+using detail::FlatMap;
+using detail::HashMap;
+using detail::OrderedMap;
+using detail::TreeMap;
+
+// BasicJson 的编译期策略. 自定义时从 JsonTraits 派生, 只改写需要的成员:
+//   Number          浮点数的类型, double 或 float
+//   Allocator<T>    容器和堆上载荷所用的无状态分配器
+//   String          字符串值的类型
+//   Array<J, A>     数组容器, A 为元素的分配器
+//   Object<J, A>    对象容器, 可选上面四种之一
+struct JsonTraits {
+    using Number = double;
+
+    template <typename T>
+    using Allocator = std::allocator<T>;
+
+    using String = std::string;
+
+    template <typename J, typename A>
+    using Array = std::vector<J, A>;
+
+#if defined(ZJSON_TREE_OBJECT)
+    template <typename J, typename A>
+    using Object = TreeMap<J, A>;
+#elif defined(ZJSON_FLAT_OBJECT)
+    template <typename J, typename A>
+    using Object = FlatMap<J, A>;
+#elif defined(ZJSON_HASH_OBJECT)
+    template <typename J, typename A>
+    using Object = HashMap<J, A>;
+#else
+    template <typename J, typename A>
+    using Object = OrderedMap<J, A>;
+#endif
+};
+
+// 字符串和容器都经 ResourceAllocator 分配, 配合 ResourceScope 使用
+struct PmrJsonTraits : JsonTraits {
+    template <typename T>
+    using Allocator = ResourceAllocator<T>;
+
+    using String = std::basic_string<char, std::char_traits<char>,
+                                     ResourceAllocator<char>>;
+};
+
+using Json = BasicJson<JsonTraits>;
+using PmrJson = BasicJson<PmrJsonTraits>;
+
+class Cursor;
+template <typename Traits>
+class BasicDocument;
+class Tape;
+
+// JSON 值. 堆上的数组/对象载荷带引用计数, 拷贝节点只增加计数, 修改前仍被
+// 共享才复制一份 (copy-on-write). 非 const 的 operator[], at, 命中的 find,
+// getRef/getIf, begin/end, items 以及 JsonPointer::set/erase 交出的是载荷内部的
+// 引用, 之后是否经它写入无从得知, 所以交出前让本节点独占载荷并标为不再共享:
+// 此后拷贝本节点都要复制这一层 (其中的子容器仍只增加计数), 这个标记也不会
+// 自动清除. 只读访问请经 const 引用 (std::as_const) 进行; 不再持有引用后,
+// json = BasicJson(json) 可换回可共享的载荷.
+// 默认的对象容器把成员存在连续数组中, 向对象插入新成员可能使先前取得的成员
+// 引用 (如 obj["a"] 的返回值) 失效, erase 会使被删成员之后的引用失效;
+// 需要成员引用在插入后保持有效时改用 ZJSON_TREE_OBJECT
+template <typename Traits>
+class BasicJson {
+public:
+    using Boolean = bool;
+    using Number = typename Traits::Number;
+    using Int64 = std::int64_t;
+    using Uint64 = std::uint64_t;
+    using String = typename Traits::String;
+    using Array = typename Traits::template Array<
+        BasicJson, detail::Allocator<BasicJson, typename Traits::template
+                                                    Allocator<BasicJson>>>;
+    using Object = typename Traits::template Object<
+        BasicJson, detail::Allocator<BasicJson, typename Traits::template
+                                                    Allocator<BasicJson>>>;
+    // 长键经 Traits::Allocator 分配
+    using Key = typename Object::key_type;
+
+    static_assert(std::is_floating_point<Number>::value,
+                  "Traits::Number should be a floating-point type");
+
+    union Value {
+        Boolean boolean;
+        Number number;
+        Int64 int64;
+        Uint64 uint64;
+        String *str;
+        detail::Shared<Array> *array;
+        detail::Shared<Object> *object;
+        const char *view;  // 长度存在 size_ 中
+    };
+
+    // 同一 Type 下 value_ 的实际存储方式. 整数优先存为 kInt64,
+    // 只有超出 int64 范围的非负整数才用 kUint64; kView 的字符串存在 view 中.
+    // kArena 的字符串 (view) 和容器分配在 Document 的 arena 中, 不单独释放;
+    // kInline 的短字符串直接存在节点内, 不分配内存
+    enum class Kind : uint8_t {
+        kDefault,
+        kInt64,
+        kUint64,
+        kView,
+        kArena,
+        kInline
+    };
+
+public:
+    inline static const char *kLiteralNull = "null";
+    inline static const char *kLiteralTrue = "true";
+    inline static const char *kLiteralFalse = "false";
+
+    // 数组/对象的默认最大嵌套层数, 超过时解析失败
+    inline static const size_t kDefaultMaxDepth = 1024;
+
+public:
+    void clear() {
+        release();
+        set_null();
+    }
+
+    void copy(const BasicJson &other) {
+        switch (other.type()) {
+            case Type::kBoolean: set_boolean(other.boolean()); break;
+            case Type::kNumber:
+                switch (other.kind()) {
+                    case Kind::kInt64: set_int64(other.int64()); break;
+                    case Kind::kUint64: set_uint64(other.uint64()); break;
+                    default: set_number(other.number()); break;
+                }
+                break;
+            case Type::kString:
+                // 原地解析的字符串拷贝后仍引用原缓冲区, 其余都拷贝为自有的
+                if (other.kind() == Kind::kView &&
+                    set_view(other.str_view(), Kind::kView)) {
+                    break;
+                }
+                set_owned_string(other.str_view());
+                break;
+            // 堆上的容器共享同一份载荷; arena 中的容器, 以及交出过可变引用的
+            // 容器拷贝到堆上
+            case Type::kArray:
+                if (other.kind() == Kind::kDefault &&
+                    !leaked(other.shared_array())) {
+                    set_array(share(other.shared_array()));
+                } else {
+                    copy_container(other);
+                }
+                break;
+            case Type::kObject:
+                if (other.kind() == Kind::kDefault &&
+                    !leaked(other.shared_object())) {
+                    set_object(share(other.shared_object()));
+                } else {
+                    copy_container(other);
+                }
+                break;
+            default: set_null(); break;
+        }
+    }
+
+    BasicJson() { set_null(); }
+
+    BasicJson(const BasicJson &other) { copy(other); }
+
+    BasicJson &operator=(const BasicJson &other) {
+        if (this != &other) {
+            clear();
+            copy(other);
+        }
+        return *this;
+    }
+
+    BasicJson(BasicJson &&other) noexcept { move(other); }
+
+    BasicJson &operator=(BasicJson &&other) noexcept {
+        if (this != &other) {
+            clear();
+            move(other);
+        }
+        return *this;
+    }
+
+    ~BasicJson() { clear(); }
+
+    BasicJson(Number number) { set_number(number); }
+
+    // Number 不是 double 时, 其余浮点字面量按 Number 收窄
+    template <typename T,
+              typename std::enable_if<std::is_floating_point<T>::value &&
+                                          !std::is_same<T, Number>::value,
+                                      int>::type = 0>
+    BasicJson(T number) {
+        set_number(Number(number));
+    }
+
+    template <typename T,
+              typename std::enable_if<std::is_integral<T>::value &&
+                                          !std::is_same<T, Boolean>::value,
+                                      int>::type = 0>
+    BasicJson(T number) {
+        if (std::is_signed<T>::value || Uint64(number) <= INT64_MAX) {
+            set_int64(Int64(number));
+        } else {
+            set_uint64(Uint64(number));
+        }
+    }
+
+    explicit BasicJson(Boolean b) { set_boolean(b); }
+
+    BasicJson(const char *str) { set_owned_string(str); }
+
+    BasicJson(std::string_view sv) { set_owned_string(sv); }
+
+    // 接管整个容器, 与 take 配合可以把子树移出, 修改后再放回而不拷贝
+    explicit BasicJson(Array array) {
+        set_array(construct<SharedArray>(std::move(array)));
+    }
+
+    explicit BasicJson(Object object) {
+        set_object(construct<SharedObject>(std::move(object)));
+    }
+
+    Type getType() const { return type(); }
+
+    // 非 const 的访问会先让容器独占载荷, 并标为不再共享: 之后拷贝本节点时
+    // 复制这一层, 经返回的引用所做的修改不会影响到副本. 找不到时不标记
+    BasicJson &operator[](size_t idx) {
+        check_type(Type::kArray, "array");
+        if (idx >= array()->size()) {
+            ZJSON_THROW(std::out_of_range("array index out of range!"));
+        }
+        return (*mutable_array())[idx];
+    }
+
+    const BasicJson &operator[](size_t idx) const {
+        check_type(Type::kArray, "array");
+        return array()->at(idx);
+    }
+
+    // 按键查找都接受 std::string_view, 不构造临时的 std::string 或 Key.
+    // find 在不是对象或没有该键时返回空指针, at 和 const operator[] 则抛出异常
+    const BasicJson *find(std::string_view key) const {
+        if (type() != Type::kObject) return nullptr;
+        auto it = object()->find(key);
+        return it == object()->end() ? nullptr : &it->second;
+    }
+
+    BasicJson *find(std::string_view key) {
+        if (type() != Type::kObject) return nullptr;
+        Object *shared = object();
+        auto it = shared->find(key);
+        if (it == shared->end()) return nullptr;
+        // 没有复制载荷时迭代器仍然有效, 否则在复制出的载荷中再找一次
+        Object *members = mutable_object();
+        return members == shared ? &it->second : &members->at(key);
+    }
+
+    // 同 find(key), 用预先算好的哈希查找
+    const BasicJson *find(const HashedKey &key) const {
+        if (type() != Type::kObject) return nullptr;
+        auto it = object()->find(key);
+        return it == object()->end() ? nullptr : &it->second;
+    }
+
+    BasicJson *find(const HashedKey &key) {
+        if (type() != Type::kObject) return nullptr;
+        Object *shared = object();
+        auto it = shared->find(key);
+        if (it == shared->end()) return nullptr;
+        Object *members = mutable_object();
+        return members == shared ? &it->second : &members->find(key)->second;
+    }
+
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    // 不是数组或越界时返回空指针
+    const BasicJson *find(size_t idx) const {
+        if (type() != Type::kArray || idx >= array()->size()) return nullptr;
+        return &(*array())[idx];
+    }
+
+    BasicJson *find(size_t idx) {
+        if (type() != Type::kArray || idx >= array()->size()) return nullptr;
+        return &(*mutable_array())[idx];
+    }
+
+    bool contain(std::string_view key) const {
+        check_type(Type::kObject, "object");
+        return contains(key);
+    }
+
+    BasicJson &at(std::string_view key) {
+        check_type(Type::kObject, "object");
+        BasicJson *member = find(key);
+        if (!member) ZJSON_THROW(std::out_of_range("key not found!"));
+        return *member;
+    }
+
+    const BasicJson &at(std::string_view key) const {
+        check_type(Type::kObject, "object");
+        return object()->at(key);
+    }
+
+    BasicJson &operator[](std::string_view key) {
+        if (type() == Type::kNull) {
+            make_object(nullptr);
+        } else {
+            check_type(Type::kObject, "object");
+        }
+        return (*mutable_object())[key];
+    }
+
+    const BasicJson &operator[](std::string_view key) const { return at(key); }
+
+    // 按值取出; 字符串还可以按 std::string_view 取出, 不拷贝内容, 在节点
+    // 被修改或销毁前有效. 容器按值取出会拷贝整棵子树, 只读时用 getRef
+    template <typename T>
+    T get() const {
+        if constexpr (std::is_same<T, Boolean>::value) {
+            check_type(Type::kBoolean, "Boolean");
+            return boolean();
+        } else if constexpr (std::is_integral<T>::value) {
+            check_type(Type::kNumber,
+                       std::is_signed<T>::value ? "Int64" : "Uint64");
+            std::optional<T> value = integer<T>();
+            if (!value) ZJSON_THROW(std::runtime_error("number out of range!"));
+            return *value;
+        } else if constexpr (std::is_floating_point<T>::value) {
+            check_type(Type::kNumber, "Number");
+            return T(number_value());
+        } else if constexpr (std::is_same<T, std::string_view>::value) {
+            check_type(Type::kString, "String");
+            return str_view();
+        } else if constexpr (std::is_same<T, String>::value) {
+            check_type(Type::kString, "String");
+            return String(str_view());
+        } else if constexpr (std::is_same<T, Array>::value) {
+            check_type(Type::kArray, "Array");
+            return *array();
+        } else if constexpr (std::is_same<T, Object>::value) {
+            check_type(Type::kObject, "Object");
+            return *object();
+        }
+        ZJSON_THROW(std::runtime_error("type error"));
+    }
+
+    // 不抛出异常的 get: 类型不符或数值不能用 T 精确表示时返回 std::nullopt
+    template <typename T>
+    std::optional<T> tryGet() const {
+        if constexpr (std::is_same<T, Boolean>::value) {
+            if (type() != Type::kBoolean) return std::nullopt;
+            return boolean();
+        } else if constexpr (std::is_integral<T>::value) {
+            if (type() != Type::kNumber) return std::nullopt;
+            return integer<T>();
+        } else if constexpr (std::is_floating_point<T>::value) {
+            if (type() != Type::kNumber) return std::nullopt;
+            return T(number_value());
+        } else if constexpr (std::is_same<T, std::string_view>::value ||
+                             std::is_same<T, String>::value) {
+            if (type() != Type::kString) return std::nullopt;
+            return T(str_view());
+        } else if constexpr (std::is_same<T, Array>::value) {
+            if (type() != Type::kArray) return std::nullopt;
+            return *array();
+        } else {
+            static_assert(std::is_same<T, Object>::value,
+                          "tryGet<T>: unsupported type");
+            if (type() != Type::kObject) return std::nullopt;
+            return *object();
+        }
+    }
+
+    // tryGet 失败时返回 fallback; 字符串字面量按 std::string_view 取出
+    template <typename T, typename V = detail::OrValue<T>>
+    V valueOr(T fallback) const {
+        std::optional<V> value = tryGet<V>();
+        return value ? std::move(*value) : V(std::move(fallback));
+    }
+
+    // 不是对象或没有该成员时同样返回 fallback
+    template <typename T, typename V = detail::OrValue<T>>
+    V valueOr(std::string_view key, T fallback) const {
+        const BasicJson *member = find(key);
+        return member ? member->valueOr(std::move(fallback))
+                      : V(std::move(fallback));
+    }
+
+    // 容器的引用, 不拷贝. 非 const 版本与 operator[] 一样先让本节点独占载荷.
+    // 类型不符是调用方的错误, 抛出 std::logic_error; 以 -fno-exceptions
+    // 编译时会 abort, 这时应改用 getIf
+    template <typename T>
+    const T &getRef() const {
+        const T *value = getIf<T>();
+        if (!value) container_mismatch<T>();
+        return *value;
+    }
+
+    template <typename T>
+    T &getRef() {
+        T *value = getIf<T>();
+        if (!value) container_mismatch<T>();
+        return *value;
+    }
+
+    // 不抛出异常的 getRef: 类型不符时返回空指针
+    template <typename T>
+    const T *getIf() const {
+        static_assert(std::is_same<T, Array>::value ||
+                          std::is_same<T, Object>::value,
+                      "getIf<T>: T must be Array or Object");
+        if constexpr (std::is_same<T, Array>::value) {
+            return type() == Type::kArray ? array() : nullptr;
+        } else {
+            return type() == Type::kObject ? object() : nullptr;
+        }
+    }
+
+    template <typename T>
+    T *getIf() {
+        static_assert(std::is_same<T, Array>::value ||
+                          std::is_same<T, Object>::value,
+                      "getIf<T>: T must be Array or Object");
+        if constexpr (std::is_same<T, Array>::value) {
+            return type() == Type::kArray ? mutable_array() : nullptr;
+        } else {
+            return type() == Type::kObject ? mutable_object() : nullptr;
+        }
+    }
+
+    // 把值移出本节点, 之后本节点为 null. 堆上独占的字符串和容器直接移动;
+    // 仍与其他副本共享或在 arena 中的载荷只能拷贝一份
+    template <typename T>
+    T take() && {
+        static_assert(
+            !std::is_same<T, std::string_view>::value,
+            "take<T>: the view would dangle once the node is cleared");
+        T value = take_value<T>();
+        clear();
+        return value;
+    }
+
+    // 依次访问数组的元素或对象的成员, 对象成员的键由 key() 取得. 与容器的
+    // 迭代器一样是线性遍历, 不分配内存
+    template <bool kConst>
+    class Iterator {
+    public:
+        using Value =
+            typename std::conditional<kConst, const BasicJson, BasicJson>::type;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = BasicJson;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value *;
+        using reference = Value &;
+
+        Iterator() = default;
+        template <bool kOther,
+                  typename std::enable_if<kConst && !kOther, int>::type = 0>
+        Iterator(const Iterator<kOther> &other)
+            : element_(other.element_),
+              member_(other.member_),
+              object_(other.object_) {}
+
+        Value &operator*() const {
+            return object_ ? member_->second : *element_;
+        }
+        Value *operator->() const { return &**this; }
+
+        // 数组元素没有键, 返回空视图
+        std::string_view key() const {
+            return object_ ? std::string_view(member_->first)
+                           : std::string_view();
+        }
+
+        Iterator &operator++() {
+            if (object_) {
+                ++member_;
+            } else {
+                ++element_;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const Iterator &other) const {
+            return object_ ? member_ == other.member_
+                           : element_ == other.element_;
+        }
+        bool operator!=(const Iterator &other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class BasicJson;
+        template <bool>
+        friend class Iterator;
+
+        using ElementIterator =
+            typename std::conditional<kConst, typename Array::const_iterator,
+                                      typename Array::iterator>::type;
+        using MemberIterator =
+            typename std::conditional<kConst, typename Object::const_iterator,
+                                      typename Object::iterator>::type;
+
+        explicit Iterator(ElementIterator it) : element_(it) {}
+        explicit Iterator(MemberIterator it) : member_(it), object_(true) {}
+
+        ElementIterator element_{};
+        MemberIterator member_{};
+        bool object_ = false;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // 数组的元素个数或对象的成员个数
+    size_t size() const {
+        if (type() == Type::kArray) return array()->size();
+        check_type(Type::kObject, "array or object");
+        return object()->size();
+    }
+
+    // 只读遍历请经 const 引用进行; 非 const 的 begin/end 与 operator[] 一样
+    // 先让本节点独占载荷
+    const_iterator begin() const {
+        if (type() == Type::kArray) {
+            return const_iterator(std::as_const(*array()).begin());
+        }
+        check_type(Type::kObject, "array or object");
+        return const_iterator(std::as_const(*object()).begin());
+    }
+
+    const_iterator end() const {
+        if (type() == Type::kArray) {
+            return const_iterator(std::as_const(*array()).end());
+        }
+        check_type(Type::kObject, "array or object");
+        return const_iterator(std::as_const(*object()).end());
+    }
+
+    iterator begin() {
+        if (type() == Type::kArray) return iterator(mutable_array()->begin());
+        check_type(Type::kObject, "array or object");
+        return iterator(mutable_object()->begin());
+    }
+
+    iterator end() {
+        if (type() == Type::kArray) return iterator(mutable_array()->end());
+        check_type(Type::kObject, "array or object");
+        return iterator(mutable_object()->end());
+    }
+
+    // 按 (键, 值) 遍历对象: for (auto [key, value] : json.items()),
+    // key 为 std::string_view, value 为成员的引用
+    template <bool kConst>
+    class Items {
+    public:
+        struct Member {
+            std::string_view key;
+            typename Iterator<kConst>::Value &value;
+        };
+
+        class iterator {
+        public:
+            Member operator*() const { return {it_.key(), *it_}; }
+
+            iterator &operator++() {
+                ++it_;
+                return *this;
+            }
+
+            bool operator==(const iterator &other) const {
+                return it_ == other.it_;
+            }
+            bool operator!=(const iterator &other) const {
+                return it_ != other.it_;
+            }
+
+        private:
+            friend class Items;
+
+            explicit iterator(Iterator<kConst> it) : it_(it) {}
+
+            Iterator<kConst> it_;
+        };
+
+        iterator begin() const { return iterator(begin_); }
+        iterator end() const { return iterator(end_); }
+
+    private:
+        friend class BasicJson;
+
+        Items(Iterator<kConst> begin, Iterator<kConst> end)
+            : begin_(begin), end_(end) {}
+
+        Iterator<kConst> begin_;
+        Iterator<kConst> end_;
+    };
+
+    Items<true> items() const {
+        check_type(Type::kObject, "object");
+        return {begin(), end()};
+    }
+
+    Items<false> items() {
+        check_type(Type::kObject, "object");
+        iterator first = begin();
+        return {first, end()};
+    }
+
+    bool isNull() const { return type() == Type::kNull; }
+    bool isBoolean() const { return type() == Type::kBoolean; }
+    bool isNumber() const { return type() == Type::kNumber; }
+    bool isInteger() const {
+        return type() == Type::kNumber && kind() != Kind::kDefault;
+    }
+    bool isString() const { return type() == Type::kString; }
+    bool isArray() const { return type() == Type::kArray; }
+    bool isObject() const { return type() == Type::kObject; }
+
+    static BasicJson parse(std::string_view text,
+                           Engine engine = Engine::kOnePass,
+                           size_t max_depth = kDefaultMaxDepth) {
+        return parse_root<false>(text.data(), text.data() + text.size(),
+                                 engine, max_depth);
+    }
+
+    // 原地解析: 字符串在 text 内反转义, 结果中的字符串值和键都直接引用 text,
+    // 不再分配内存. text 会被改写, 且必须在结果及其拷贝销毁前保持有效
+    static BasicJson parseInsitu(char *text, size_t len,
+                                 Engine engine = Engine::kOnePass,
+                                 size_t max_depth = kDefaultMaxDepth) {
+        return parse_root<true>(text, text + len, engine, max_depth);
+    }
+
+    // 不抛出异常的 parse: 结果放在本节点, 失败时本节点为 null,
+    // 返回值给出原因和出错的位置
+    ParseResult tryParse(std::string_view text,
+                         Engine engine = Engine::kOnePass,
+                         size_t max_depth = kDefaultMaxDepth) {
+        return parse_root<false>(text.data(), text.data() + text.size(),
+                                 engine, max_depth, nullptr, nullptr);
+    }
+
+    ParseResult tryParseInsitu(char *text, size_t len,
+                               Engine engine = Engine::kOnePass,
+                               size_t max_depth = kDefaultMaxDepth) {
+        return parse_root<true>(text, text + len, engine, max_depth, nullptr,
+                                nullptr);
+    }
+
+    std::string dump() const {
+        Writer writer;
+        stringify(writer);
+        return std::move(writer.out);
+    }
+
+private:
+    friend class Cursor;
+    template <typename>
+    friend class BasicDocument;
+    friend class Tape;
+
+    using SharedArray = detail::Shared<Array>;
+    using SharedObject = detail::Shared<Object>;
+
+    struct ParseState {
+        std::vector<BasicJson> nodes;  // 尚未闭合的数组/对象, 栈顶为最内层
+        std::vector<Key> keys;         // 各层对象中正在解析的成员的键
+        std::string scratch;           // 含转义的字符串先解码到这里
+        detail::Arena *arena;          // 为空时节点分配在全局堆上
+        detail::KeyTable *key_table;   // 不为空时键都放入这个键表
+        const char *error;             // 出错的记号, 为空表示在输入末尾
+    };
+
+    template <bool kInsitu>
+    static BasicJson parse_root(const char *begin, const char *end,
+                                Engine engine, size_t max_depth) {
+        BasicJson json;
+        ParseResult result =
+            json.parse_root<kInsitu>(begin, end, engine, max_depth, nullptr,
+                                     nullptr);
+        if (!result) ZJSON_THROW(ParseError(result));
+        return json;
+    }
+
+    template <bool kInsitu>
+    ParseResult parse_root(const char *begin, const char *end, Engine engine,
+                           size_t max_depth, detail::Arena *arena,
+                           detail::KeyTable *key_table) {
+        const char *error = nullptr;
+        Ret ret = engine == Engine::kTwoStage
+                      ? parse_two_stage<kInsitu>(begin, end, max_depth, arena,
+                                                 key_table, &error)
+                      : parse<kInsitu>(begin, end, max_depth, arena, key_table,
+                                       &error);
+        return ParseResult::at(ret, begin, end, error);
+    }
+
+    // 出错时 *error 为出错的记号, 为空表示在输入末尾
+    template <bool kInsitu = false>
+    Ret parse(const char *text, const char *end,
+              size_t max_depth = kDefaultMaxDepth,
+              detail::Arena *arena = nullptr,
+              detail::KeyTable *key_table = nullptr,
+              const char **error = nullptr) {
+        clear();
+        detail::TextSource source{text, end};
+        return parse_document<kInsitu>(source, max_depth, arena, key_table,
+                                       error);
+    }
+
+    template <bool kInsitu = false>
+    Ret parse_two_stage(const char *text, const char *end,
+                        size_t max_depth = kDefaultMaxDepth,
+                        detail::Arena *arena = nullptr,
+                        detail::KeyTable *key_table = nullptr,
+                        const char **error = nullptr) {
+        // 结构索引用 32 位偏移, 超出范围的输入退回单趟解析
+        if (size_t(end - text) > UINT32_MAX) {
+            return parse<kInsitu>(text, end, max_depth, arena, key_table,
+                                  error);
+        }
+        clear();
+
+        detail::StructuralIndex index;
+        index.build(text, end - text);
+        detail::Tokens tokens{text, end, index.begin(), index.end()};
+        return parse_document<kInsitu>(tokens, max_depth, arena, key_table,
+                                       error);
+    }
+
+    template <bool kInsitu, typename Source>
+    Ret parse_document(Source &source, size_t max_depth, detail::Arena *arena,
+                       detail::KeyTable *key_table, const char **error) {
+        Ret ret =
+            parse_value<kInsitu>(source, max_depth, arena, key_table, error);
+        if (ret != Ret::kParseOk) return ret;
+
+        if (const char *junk = source.peek()) {
+            clear();
+            if (error) *error = junk;
+            return Ret::kParseRootNotSingular;
+        }
+
+        return ret;
+    }
+
+    // 序列化的输出缓冲区, 整次 dump 共用一个, 节点本身不再带缓冲
+    struct Writer {
+        std::string out;
+
+        void push(char ch) { out.push_back(ch); }
+        void push(std::string_view s) { out.append(s.data(), s.size()); }
+    };
+
+    void stringify_boolean(Writer &writer) const {
+        writer.push(boolean() ? kLiteralTrue : kLiteralFalse);
+    }
+
+    // 非递归序列化: 尚未写完的数组/对象放在显式的栈上, 与解析一样不随
+    // 嵌套层数占用调用栈
+    void stringify(Writer &writer) const {
+        struct Frame {
+            const BasicJson *node;
+            size_t idx;  // 已写出的元素/成员个数
+            typename Object::const_iterator member;
+        };
+        std::vector<Frame> stack;
+        const BasicJson *node = this;
+        for (;;) {
+            switch (node->type()) {
+                case Type::kNull: writer.push(kLiteralNull); break;
+                case Type::kBoolean: node->stringify_boolean(writer); break;
+                case Type::kNumber: node->stringify_number(writer); break;
+                case Type::kString: node->stringify_string(writer); break;
+                case Type::kArray:
+                    writer.push('[');
+                    stack.push_back({node, 0, {}});
+                    break;
+                case Type::kObject:
+                    writer.push('{');
+                    stack.push_back(
+                        {node, 0, std::as_const(*node->object()).begin()});
+                    break;
+                default: break;
+            }
+
+            // 取栈顶容器的下一个值; 写完的容器随之闭合, 继续向上
+            for (node = nullptr; !node;) {
+                if (stack.empty()) return;
+                Frame &top = stack.back();
+                if (top.node->type() == Type::kArray) {
+                    const Array &array = *top.node->array();
+                    if (top.idx < array.size()) {
+                        if (top.idx != 0) writer.push(',');
+                        node = &array[top.idx++];
+                        continue;
+                    }
+                    writer.push(']');
+                } else {
+                    const Object &object = *top.node->object();
+                    if (top.member != object.end()) {
+                        if (top.idx++ != 0) writer.push(',');
+                        stringify_string_raw(writer, top.member->first);
+                        writer.push(':');
+                        node = &top.member->second;
+                        ++top.member;
+                        continue;
+                    }
+                    writer.push('}');
+                }
+                stack.pop_back();
+            }
+        }
+    }
+
+    bool is_null() const { return type() == Type::kNull; }
+
+    bool is_bool(bool b) const { return type() == Type::kBoolean; }
+    double get_number() const { return get<Number>(); }
+
+    Int64 get_int64() const { return get<Int64>(); }
+
+    Uint64 get_uint64() const { return get<Uint64>(); }
+
+    Number number_value() const {
+        switch (kind()) {
+            case Kind::kInt64: return Number(int64());
+            case Kind::kUint64: return Number(uint64());
+            default: return number();
+        }
+    }
+
+    // 按整数 T 取出, 不能精确表示时为空. double 只有恰好是整数且不越界时才行
+    template <typename T>
+    std::optional<T> integer() const {
+        switch (kind()) {
+            case Kind::kInt64: return narrow<T>(int64());
+            case Kind::kUint64: return narrow<T>(uint64());
+            default: {
+                Number d = number();
+                if (std::trunc(d) != d) return std::nullopt;
+                if (d >= -0x1p63 && d < 0x1p63) return narrow<T>(Int64(d));
+                if (d >= 0 && d < 0x1p64) return narrow<T>(Uint64(d));
+                return std::nullopt;
+            }
+        }
+    }
+
+    template <typename T, typename N>
+    static std::optional<T> narrow(N n) {
+        if constexpr (std::is_signed<N>::value) {
+            if (n < 0) {
+                if (!std::is_signed<T>::value ||
+                    n < Int64(std::numeric_limits<T>::min())) {
+                    return std::nullopt;
+                }
+                return T(n);
+            }
+        }
+        if (Uint64(n) > Uint64(std::numeric_limits<T>::max())) {
+            return std::nullopt;
+        }
+        return T(n);
+    }
+
+    const char *get_string() const {
+        check_type(Type::kString, "string");
+        return str_view().data();
+    }
+
+    std::string_view str_view() const {
+        if (kind() == Kind::kDefault) return *str();
+        return view();
+    }
+
+    size_t get_array_size() const {
+        check_type(Type::kArray, "array");
+        return array()->size();
+    }
+
+    BasicJson &get_array_element(size_t idx) const {
+        check_type(Type::kArray, "array");
+        return (*array())[idx];
+    }
+
+    // 非递归解析: 尚未闭合的数组/对象放在每个线程复用的堆上栈中, 而不是占用
+    // 调用栈, 嵌套层数超过 max_depth 时返回 kParseDepthExceeded
+    template <bool kInsitu, typename Source>
+    Ret parse_value(Source &source, size_t max_depth,
+                    detail::Arena *arena = nullptr,
+                    detail::KeyTable *key_table = nullptr,
+                    const char **error = nullptr) {
+        thread_local ParseState state;
+        state.arena = arena;
+        state.key_table = key_table;
+        Ret ret = parse_value<kInsitu>(source, max_depth, state);
+        state.nodes.clear();
+        state.keys.clear();
+        if (ret != Ret::kParseOk && error) *error = state.error;
+        return ret;
+    }
+
+    template <bool kInsitu, typename Source>
+    Ret parse_value(Source &source, size_t max_depth, ParseState &state) {
+        std::vector<BasicJson> &nodes = state.nodes;
+        std::vector<Key> &keys = state.keys;
+        // 出错返回时 text 停在出错的记号上
+        const char *&text = state.error;
+        BasicJson value;
+        for (;;) {
+            // 标量直接解析完; 非空的数组/对象入栈, 接着解析它的第一个成员
+            text = source.peek();
+            if (!text) return Ret::kParseExpectValue;
+            Ret ret;
+            switch (*text) {
+                case '[':
+                    if (nodes.size() >= max_depth) {
+                        return Ret::kParseDepthExceeded;
+                    }
+                    source.advance();
+                    text = source.peek();
+                    if (!text) return Ret::kParseMissCommaOrSquareBracket;
+                    if (*text == ']') {
+                        source.advance();
+                        value.clear();
+                        value.make_array(state.arena);
+                        break;
+                    }
+                    nodes.emplace_back();
+                    nodes.back().make_array(state.arena);
+                    continue;
+                case '{':
+                    if (nodes.size() >= max_depth) {
+                        return Ret::kParseDepthExceeded;
+                    }
+                    source.advance();
+                    text = source.peek();
+                    if (!text) return Ret::kParseMissCommaOrCurlyBracket;
+                    if (*text == '}') {
+                        source.advance();
+                        value.clear();
+                        value.make_object(state.arena);
+                        break;
+                    }
+                    nodes.emplace_back();
+                    nodes.back().make_object(state.arena);
+                    keys.emplace_back();
+                    ret = parse_member_key<kInsitu>(source, keys.back(), state);
+                    if (ret != Ret::kParseOk) return ret;
+                    continue;
+                default: {
+                    value.clear();
+                    text = source.begin_scalar();
+                    const char *p = text;
+                    ret = value.parse_scalar<kInsitu>(p, source.end, state);
+                    if (ret != Ret::kParseOk) return ret;
+                    source.end_scalar(p);
+                } break;
+            }
+
+            // value 已完整, 放入外层容器; 外层随之闭合时继续向上
+            for (;;) {
+                if (nodes.empty()) {
+                    *this = std::move(value);
+                    return Ret::kParseOk;
+                }
+                BasicJson &parent = nodes.back();
+                text = source.peek();
+                if (parent.type() == Type::kArray) {
+                    parent.array()->emplace_back(std::move(value));
+                    if (!text) return Ret::kParseMissCommaOrSquareBracket;
+                    if (*text == ',') {
+                        source.advance();
+                        break;
+                    } else if (*text != ']') {
+                        return Ret::kParseMissCommaOrSquareBracket;
+                    }
+                } else {
+                    parent.object()->append(std::move(keys.back()),
+                                            std::move(value));
+                    if (!text) return Ret::kParseMissCommaOrCurlyBracket;
+                    if (*text == ',') {
+                        source.advance();
+                        ret = parse_member_key<kInsitu>(source, keys.back(),
+                                                        state);
+                        if (ret != Ret::kParseOk) return ret;
+                        break;
+                    } else if (*text != '}') {
+                        return Ret::kParseMissCommaOrCurlyBracket;
+                    }
+                    parent.object()->seal();
+                    keys.pop_back();
+                }
+                source.advance();
+                value = std::move(parent);
+                nodes.pop_back();
+            }
+        }
+    }
+
+    // 放得下的内联存放, 否则拷贝到堆上
+    void set_owned_string(std::string_view sv) {
+        if (!set_inline(sv)) set_string(construct<String>(sv));
+    }
+
+    void make_array(detail::Arena *arena) {
+        if (arena) {
+            void *p =
+                arena->allocate(sizeof(SharedArray), alignof(SharedArray));
+            set_array(
+                new (p) SharedArray(typename Array::allocator_type(arena)),
+                Kind::kArena);
+        } else {
+            set_array(construct<SharedArray>());
+        }
+    }
+
+    void make_object(detail::Arena *arena) {
+        if (arena) {
+            void *p =
+                arena->allocate(sizeof(SharedObject), alignof(SharedObject));
+            set_object(
+                new (p) SharedObject(typename Object::allocator_type(arena)),
+                Kind::kArena);
+        } else {
+            set_object(construct<SharedObject>());
+        }
+    }
+
+    Array *array() const { return &shared_array()->value; }
+    Object *object() const { return &shared_object()->value; }
+
+    template <typename T>
+    T take_value() {
+        if constexpr (std::is_same<T, String>::value) {
+            check_type(Type::kString, "String");
+            if (kind() == Kind::kDefault) return std::move(*str());
+            return String(str_view());
+        } else if constexpr (std::is_same<T, Array>::value) {
+            check_type(Type::kArray, "Array");
+            if (owns_payload(shared_array())) return std::move(*array());
+            return *array();
+        } else if constexpr (std::is_same<T, Object>::value) {
+            check_type(Type::kObject, "Object");
+            if (owns_payload(shared_object())) return std::move(*object());
+            return *object();
+        } else {
+            return get<T>();
+        }
+    }
+
+    template <typename T>
+    bool owns_payload(detail::Shared<T> *shared) const {
+        return kind() == Kind::kDefault &&
+               shared->refs.load(std::memory_order_acquire) <= 1;
+    }
+
+    template <typename T>
+    static bool leaked(detail::Shared<T> *shared) {
+        return shared->refs.load(std::memory_order_acquire) == 0;
+    }
+
+    // 交出容器的可变引用或迭代器前调用: 载荷仍与其他节点共享时先复制一份
+    // 自己的, 再标为不可共享 (同旧式 COW std::string 的 leak). 调用方可能
+    // 一直留着引用, 所以不再恢复共享
+    Array *mutable_array() {
+        SharedArray *shared = shared_array();
+        if (kind() == Kind::kDefault) {
+            if (shared->refs.load(std::memory_order_acquire) > 1) {
+                set_array(construct<SharedArray>(shared->value));
+                unshare(shared);
+            }
+            shared_array()->refs.store(0, std::memory_order_relaxed);
+        }
+        return array();
+    }
+
+    Object *mutable_object() {
+        SharedObject *shared = shared_object();
+        if (kind() == Kind::kDefault) {
+            if (shared->refs.load(std::memory_order_acquire) > 1) {
+                set_object(construct<SharedObject>(shared->value));
+                unshare(shared);
+            }
+            shared_object()->refs.store(0, std::memory_order_relaxed);
+        }
+        return object();
+    }
+
+    // 复制 other 的容器, 其中可共享的子容器只增加计数. 要复制的子容器不在
+    // 容器的拷贝构造中递归展开, 而是先置为 null 并记入当前线程的待拷贝列表,
+    // 由最外层的调用逐个补全. 容器拷贝构造时元素就地构造, 记下的地址在补全前
+    // 一直有效
+    void copy_container(const BasicJson &other) {
+        using Pending = std::vector<std::pair<BasicJson *, const BasicJson *>>;
+        thread_local Pending *pending = nullptr;
+        set_null();
+        if (pending) {
+            pending->emplace_back(this, &other);
+            return;
+        }
+        Pending list{{this, &other}};
+        struct Reset {
+            Pending *&pending;
+            ~Reset() { pending = nullptr; }
+        } reset{pending};
+        pending = &list;
+        while (!list.empty()) {
+            auto [dst, src] = list.back();
+            list.pop_back();
+            if (src->type() == Type::kArray) {
+                dst->set_array(construct<SharedArray>(*src->array()));
+            } else {
+                dst->set_object(construct<SharedObject>(*src->object()));
+            }
+        }
+    }
+
+    template <typename T>
+    static detail::Shared<T> *share(detail::Shared<T> *shared) {
+        shared->refs.fetch_add(1, std::memory_order_relaxed);
+        return shared;
+    }
+
+    // 最后一个引用释放时删除载荷
+    template <typename T>
+    static void unshare(detail::Shared<T> *shared) {
+        if (release_ref(shared)) dispose(shared);
+    }
+
+    // 释放一个引用, 返回是否为最后一个. 不可共享的载荷只有一个持有者
+    template <typename T>
+    static bool release_ref(detail::Shared<T> *shared) {
+        return leaked(shared) ||
+               shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    // 删除载荷前先把堆上的子容器移到显式的栈上, 载荷析构时不再递归; 栈中的
+    // 子容器同样只在释放最后一个引用时展开
+    template <typename T>
+    static void dispose(detail::Shared<T> *shared) {
+        std::vector<BasicJson> stack;
+        detach_containers(shared->value, stack);
+        destroy(shared);
+        while (!stack.empty()) {
+            BasicJson node = std::move(stack.back());
+            stack.pop_back();
+            if (node.type() == Type::kArray) {
+                SharedArray *array = node.shared_array();
+                node.set_null();
+                if (release_ref(array)) {
+                    detach_containers(array->value, stack);
+                    destroy(array);
+                }
+            } else {
+                SharedObject *object = node.shared_object();
+                node.set_null();
+                if (release_ref(object)) {
+                    detach_containers(object->value, stack);
+                    destroy(object);
+                }
+            }
+        }
+    }
+
+    template <typename Container>
+    static void detach_containers(Container &container,
+                                  std::vector<BasicJson> &stack) {
+        for (auto &&item : container) {
+            BasicJson &child = value_of(item);
+            if ((child.type() == Type::kArray ||
+                 child.type() == Type::kObject) &&
+                child.kind() == Kind::kDefault) {
+                stack.push_back(std::move(child));
+            }
+        }
+    }
+
+    static BasicJson &value_of(BasicJson &element) { return element; }
+    template <typename Member>
+    static BasicJson &value_of(Member &member) { return member.second; }
+
+    // 堆上的载荷都经 Traits::Allocator 分配和释放
+    template <typename T>
+    using PayloadAllocator = typename Traits::template Allocator<T>;
+
+    template <typename T, typename... Args>
+    static T *construct(Args &&...args) {
+        using Alloc = PayloadAllocator<T>;
+        Alloc alloc;
+        T *p = std::allocator_traits<Alloc>::allocate(alloc, 1);
+#if ZJSON_EXCEPTIONS
+        try {
+            construct_at(p, std::forward<Args>(args)...);
+        } catch (...) {
+            std::allocator_traits<Alloc>::deallocate(alloc, p, 1);
+            throw;
+        }
+#else
+        construct_at(p, std::forward<Args>(args)...);
+#endif
+        return p;
+    }
+
+    template <typename T, typename... Args>
+    static void construct_at(T *p, Args &&...args) {
+        if constexpr (std::is_aggregate<T>::value) {
+            ::new ((void *)p) T{std::forward<Args>(args)...};
+        } else {
+            ::new ((void *)p) T(std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename T>
+    static void destroy(T *p) {
+        using Alloc = PayloadAllocator<T>;
+        Alloc alloc;
+        p->~T();
+        std::allocator_traits<Alloc>::deallocate(alloc, p, 1);
+    }
+
+    // 解析对象成员的 "key": 部分
+    template <bool kInsitu, typename Source>
+    static Ret parse_member_key(Source &source, Key &key, ParseState &state) {
+        const char *&text = state.error;
+        text = source.peek();
+        if (!text || *text != '\"') return Ret::kParseMissKey;
+        text = source.begin_scalar();
+        const char *p = text;
+        if (parse_key<kInsitu>(p, source.end, key, state) != Ret::kParseOk) {
+            return Ret::kParseMissKey;
+        }
+        source.end_scalar(p);
+
+        text = source.peek();
+        if (!text || *text != ':') return Ret::kParseMissColon;
+        source.advance();
+        return Ret::kParseOk;
+    }
+
+    template <bool kInsitu>
+    Ret parse_scalar(const char *&text, const char *end, ParseState &state) {
+        switch (*text) {
+            case 'n': return parse_null(text, end);
+            case 't': return parse_boolean(text, end, kLiteralTrue, true);
+            case 'f': return parse_boolean(text, end, kLiteralFalse, false);
+            case '\"': return parse_string<kInsitu>(text, end, state);
+            default: return parse_number(text, end, state.arena);
+        }
+    }
+
+    template <typename T>
+    [[noreturn]] static void container_mismatch() {
+        ZJSON_THROW(std::logic_error(std::is_same<T, Array>::value
+                                         ? "text value isn't Array!"
+                                         : "text value isn't Object!"));
+    }
+
+    void check_type(Type expected, const char *msg) const {
+        if (type() != expected) {
+            std::string error_msg =
+                std::string("text value isn't' ") + msg + "!";
+            ZJSON_THROW(std::runtime_error(error_msg));
+        }
+    }
+
+    Ret parse_null(const char *&text, const char *end) {
+        for (char c : std::string_view(kLiteralNull)) {
+            if (text == end || *text++ != c) return Ret::kParseInvalidValue;
+        }
+        set_null();
+        return Ret::kParseOk;
+    }
+
+    Ret parse_boolean(const char *&text, const char *end,
+                      std::string_view literal, Boolean b) {
+        for (char c : literal) {
+            if (text == end || *text++ != c) return Ret::kParseInvalidValue;
+        }
+        set_boolean(b);
+        return Ret::kParseOk;
+    }
+
+    static bool is_digit(const char *p, const char *end) {
+        return p != end && *p >= '0' && *p <= '9';
+    }
+
+    // 数字的解析结果, kind 为 kInt64, kUint64 或 kDefault (double)
+    struct ParsedNumber {
+        Kind kind;
+        union {
+            Int64 int64;
+            Uint64 uint64;
+            double number;
+        };
+    };
+
+    Ret parse_number(const char *&text, const char *end,
+                     detail::Arena *arena) {
+        ParsedNumber n;
+        Ret ret = parse_number(text, end, n);
+        if (ret != Ret::kParseOk) return ret;
+        switch (n.kind) {
+            case Kind::kInt64: set_int64(n.int64, arena); break;
+            case Kind::kUint64: set_uint64(n.uint64, arena); break;
+            default: set_number(Number(n.number)); break;
+        }
+        return ret;
+    }
+
+    static Ret parse_number(const char *&text, const char *end,
+                            ParsedNumber &out) {
+        // 按语法校验的同时累加数字, 转换时不再重新扫描
+        detail::Decimal d;
+        const char *p = text;
+        d.negative = p != end && *p == '-';
+        if (d.negative) ++p;
+        d.int_begin = p;
+        uint64_t mantissa = 0;
+        if (p != end && *p == '0') {
+            ++p;
+        } else if (is_digit(p, end)) {
+            while (is_digit(p, end)) mantissa = mantissa * 10 + (*p++ - '0');
+        } else {
+            return Ret::kParseInvalidValue;
+        }
+        d.int_end = d.frac_begin = d.frac_end = p;
+        if (p != end && *p == '.') {
+            ++p;
+            if (!is_digit(p, end)) return Ret::kParseInvalidValue;
+            d.frac_begin = p;
+            while (is_digit(p, end)) mantissa = mantissa * 10 + (*p++ - '0');
+            d.frac_end = p;
+        }
+        d.exponent = 0;
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            ++p;
+            bool negative = p != end && *p == '-';
+            if (p != end && (*p == '+' || *p == '-')) ++p;
+            if (!is_digit(p, end)) return Ret::kParseInvalidValue;
+            while (is_digit(p, end)) {
+                // 超出 double 范围的指数不必再累加
+                if (d.exponent < 0x10000000) {
+                    d.exponent = d.exponent * 10 + (*p - '0');
+                }
+                ++p;
+            }
+            if (negative) d.exponent = -d.exponent;
+        }
+        d.mantissa = mantissa;
+
+        // 没有小数和指数的整数直接存为 int64/uint64 ("-0" 仍按 double 保留符号)
+        size_t digits = d.int_end - d.int_begin;
+        bool integral =
+            p == d.int_end &&
+            (digits < 20 || (digits == 20 && memcmp(d.int_begin,
+                                                    "18446744073709551615",
+                                                    20) <= 0));
+        if (integral && (!d.negative || (mantissa != 0 &&
+                                         mantissa <= Uint64(INT64_MAX) + 1))) {
+            if (d.negative) {
+                out.kind = Kind::kInt64;
+                out.int64 = Int64(0 - mantissa);
+            } else if (mantissa <= INT64_MAX) {
+                out.kind = Kind::kInt64;
+                out.int64 = Int64(mantissa);
+            } else {
+                out.kind = Kind::kUint64;
+                out.uint64 = mantissa;
+            }
+            text = p;
+            return Ret::kParseOk;
+        }
+
+        double number = detail::decimal_to_double(d);
+        if (std::isinf(number)) return Ret::kParseNumberTooBig;
+
+        text = p;
+        out.kind = Kind::kDefault;
+        out.number = number;
+        return Ret::kParseOk;
+    }
+
+    static int ch2hex(char ch) {
+        int hex = 0;
+        if (ch >= '0' && ch <= '9') {
+            hex = ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+            hex = ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+            hex = ch - 'A' + 10;
+        } else {
+            return -1;
+        }
+        return hex;
+    }
+
+    static int parse_hex4(const char *&text, const char *end) {
+        int code = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (text == end) return -1;
+            int hex = ch2hex(*text++);
+            if (hex < 0) return -1;
+            code = (code << 4) + hex;
+        }
+        return code;
+    }
+
+    template <typename Out>
+    static Ret encode_utf8(const char *&text, const char *end, Out &out) {
+        int code = parse_hex4(text, end);
+        if (code < 0) return Ret::kParseInvalidUnicodeHex;
+        if (code >= 0xD800 && code < 0xDC00) {
+            if (end - text < 2 || *text++ != '\\' || *text++ != 'u') {
+                return Ret::kParseInvalidUnicodeSurrogate;
+            }
+            int surrogate = parse_hex4(text, end);
+            if (surrogate < 0 || !(surrogate >= 0xDC00 && surrogate < 0xE000)) {
+                return Ret::kParseInvalidUnicodeSurrogate;
+            }
+            code = 0x10000 + (code - 0xD800) * 0x400 + (surrogate - 0xDC00);
+        }
+
+        if (code < 0x80) {
+            out.push_back(code);
+        } else if (code < 0x800) {
+            out.push_back(0xC0 | (0x1F & (code >> 6)));
+            out.push_back(0X80 | (0x3F & code));
+        } else if (code < 0x10000) {
+            out.push_back(0xE0 | (0x0F & (code >> 12)));
+            out.push_back(0X80 | (0x3F & (code >> 6)));
+            out.push_back(0X80 | (0x3F & code));
+        } else if (code <= 0x10FFFF) {
+            out.push_back(0xF0 | (0x07 & (code >> 18)));
+            out.push_back(0X80 | (0x3F & (code >> 12)));
+            out.push_back(0X80 | (0x3F & (code >> 6)));
+            out.push_back(0X80 | (0x3F & code));
+        } else {
+            return Ret::kParseInvalidUnicodeHex;
+        }
+        return Ret::kParseOk;
+    }
+
+    // 解析结果直接追加到 out: 无转义的片段整段拷贝, 只在转义处逐个处理.
+    // out 为 std::string 或原地写回的 detail::InsituWriter
+    template <typename Out>
+    static Ret parse_string_raw(const char *&text, const char *end, Out &out) {
+        ++text;
+        return decode_string(text, end, out);
+    }
+
+    // 同 parse_string_raw, text 已在开头引号之后
+    template <typename Out>
+    static Ret decode_string(const char *&text, const char *end, Out &out) {
+        for (;;) {
+            const char *run = text;
+            text = detail::scan_string(text, end);
+            out.append(run, text - run);
+            if (text == end) return Ret::kParseMissQuotationMark;
+
+            unsigned char ch = *text++;
+            if (ch == '\"') {
+                return Ret::kParseOk;
+            } else if (ch < 0x20) {
+                return Ret::kParseInvalidStringChar;
+            }
+            if (text == end) return Ret::kParseInvalidStringEscape;
+            switch (*text++) {
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case '/': out.push_back('/'); break;
+                case '\"': out.push_back('\"'); break;
+                case '\\': out.push_back('\\'); break;
+                case 'u': {
+                    Ret ret = encode_utf8(text, end, out);
+                    if (ret != Ret::kParseOk) return ret;
+                } break;
+                default: return Ret::kParseInvalidStringEscape;
+            }
+        }
+    }
+
+    // 原地解析的字符串留在输入缓冲区中. 否则不含转义的字符串 (最常见的情况)
+    // 直接引用输入, 之后只从输入拷贝一次; 含转义的才解码到 state.scratch.
+    // out 在下次解析字符串前有效
+    template <bool kInsitu>
+    static Ret parse_string_data(const char *&text, const char *end,
+                                 ParseState &state, std::string_view &out) {
+        if constexpr (kInsitu) {
+            // 由 parseInsitu 保证缓冲区可写
+            char *begin = const_cast<char *>(text) + 1;
+            detail::InsituWriter writer{begin, begin};
+            Ret ret = parse_string_raw(text, end, writer);
+            out = {begin, writer.size()};
+            return ret;
+        } else {
+            const char *begin = text + 1;
+            const char *stop = detail::scan_string(begin, end);
+            if (stop != end && *stop == '\"') {
+                text = stop + 1;
+                out = {begin, size_t(stop - begin)};
+                return Ret::kParseOk;
+            }
+            // 已扫过的片段不再重扫
+            std::string &str = state.scratch;
+            str.assign(begin, stop - begin);
+            text = stop;
+            Ret ret = decode_string(text, end, str);
+            out = str;
+            return ret;
+        }
+    }
+
+    // 短字符串都内联存放; 长的原地解析时引用输入缓冲区, 否则直接写到 arena
+    // 或堆上的 String 中, 不经 scratch
+    template <bool kInsitu>
+    Ret parse_string(const char *&text, const char *end, ParseState &state) {
+        if constexpr (!kInsitu) {
+            const char *begin = text + 1;
+            const char *stop = detail::scan_string(begin, end);
+            const char *quote = find_quote(stop, end);
+            if (quote && size_t(quote - begin) > kInlineCapacity) {
+                return parse_long_string(text, begin, stop, quote, state);
+            }
+        }
+        std::string_view str;
+        Ret ret = parse_string_data<kInsitu>(text, end, state, str);
+        if (ret != Ret::kParseOk) return ret;
+        if (set_inline(str)) return ret;
+        if (kInsitu && set_view(str, Kind::kView, state.arena)) return ret;
+        set_string(construct<String>(str));
+        return ret;
+    }
+
+    // p 为 scan_string 停下的位置, 跳过转义找到结尾引号. 字符串不完整或含
+    // 控制字符时返回空, 交给完整的解码报错
+    static const char *find_quote(const char *p, const char *end) {
+        for (;;) {
+            if (p == end) return nullptr;
+            if (*p == '\"') return p;
+            if (*p != '\\' || end - p < 2) return nullptr;
+            p = detail::scan_string(p + 2, end);
+        }
+    }
+
+    // [begin, quote) 为字符串的原文, stop 为其中第一个转义处. 解码结果不会比
+    // 原文长, 按原文长度一次分配好目的处: 此前的片段整段拷入, 其余直接解码
+    // 进去, 输入只读写一遍
+    Ret parse_long_string(const char *&text, const char *begin,
+                          const char *stop, const char *quote,
+                          ParseState &state) {
+        size_t raw = quote - begin;
+        text = stop;
+        if (detail::Arena *arena = state.arena) {
+            char *data = (char *)arena->allocate(raw, 1);
+            detail::InsituWriter writer{data, data};
+            writer.append(begin, stop - begin);
+            Ret ret = decode_string(text, quote + 1, writer);
+            if (ret != Ret::kParseOk) return ret;
+            std::string_view str(data, writer.size());
+            if (set_inline(str) || set_view(str, Kind::kArena, arena)) {
+                return ret;
+            }
+            set_string(construct<String>(str));
+            return ret;
+        }
+        String str;
+        str.reserve(raw);
+        str.append(begin, stop - begin);
+        Ret ret = decode_string(text, quote + 1, str);
+        if (ret != Ret::kParseOk) return ret;
+        if (set_inline(str)) return ret;
+        // 大量 \u 转义时解码结果远短于原文, 不留下过多的空闲容量
+        if (str.size() * 2 < raw) str.shrink_to_fit();
+        set_string(construct<String>(std::move(str)));
+        return ret;
+    }
+
+    // 原地解析的键引用输入缓冲区; 有键表时放入键表, 否则为自有的键
+    template <bool kInsitu>
+    static Ret parse_key(const char *&text, const char *end, Key &key,
+                         ParseState &state) {
+        std::string_view str;
+        Ret ret = parse_string_data<kInsitu>(text, end, state, str);
+        if (ret != Ret::kParseOk) return ret;
+        if (kInsitu) {
+            key = Key::view(str);
+        } else if (state.key_table) {
+            key = Key::interned(state.key_table->intern(str));
+        } else {
+            key = Key(str);
+        }
+        return ret;
+    }
+
+    void stringify_number(Writer &writer) const {
+        char buf[32];
+        char *end;
+        if (kind() == Kind::kInt64) {
+            end = std::to_chars(buf, buf + 32, int64()).ptr;
+        } else if (kind() == Kind::kUint64) {
+            end = std::to_chars(buf, buf + 32, uint64()).ptr;
+        } else {
+            end = format_number(buf, number());
+        }
+        writer.push(std::string_view(buf, end - buf));
+    }
+
+    // double 走最短往返格式, 其余浮点类型交给 to_chars
+    static char *format_number(char *buf, Number value) {
+        if constexpr (std::is_same<Number, double>::value) {
+            return detail::format_double(buf, value);
+        } else {
+            return std::to_chars(buf, buf + 32, value).ptr;
+        }
+    }
+
+    static void stringify_hex4(Writer &writer, int code) {
+        char buf[4];
         for (int i = 3; i >= 0; --i) {
             int x = code % 16;
             buf[i] = x < 10 ? x + '0' : x - 10 + 'A';
             code /= 16;
         }
-        buf[4] = '\0';
-        stack_push(buf);
+        writer.push(std::string_view(buf, 4));
+    }
+
+    // 按无符号字节取值: char 可能有符号, 对负数左移是未定义行为.
+    // 末尾被截断的多字节序列只读到 size 为止
+    static int stringify_utf8(Writer &writer, const char *str, size_t size) {
+        uint32_t ch = static_cast<unsigned char>(*str++);
+        int count = 1;
+        if ((ch & 0xF0) == 0xF0) {
+            count = 4;
+        } else if ((ch & 0xE0) == 0xE0) {
+            count = 3;
+        } else if ((ch & 0xC0) == 0xC0) {
+            count = 2;
+        }
+        uint32_t code = ch & (0xFFu >> count);
+        if (size_t(count) > size) count = int(size);
+        for (int i = 1; i < count; ++i) {
+            code = (code << 6) | (static_cast<unsigned char>(*str++) & 0x3F);
+        }
+        if (code < 0x10000) {
+            writer.push("\\u");
+            stringify_hex4(writer, int(code));
+        } else {
+            code -= 0x10000;
+            int H = int(code / 0x400 + 0xD800);
+            int L = int(code % 0x400 + 0xDC00);
+            writer.push("\\u");
+            stringify_hex4(writer, H);
+            writer.push("\\u");
+            stringify_hex4(writer, L);
+        }
+        return count;
+    }
+
+    static void stringify_string_raw(Writer &writer, std::string_view str) {
+        writer.push('\"');
+        size_t pos = 0;
+        while (pos < str.size()) {
+            switch (str[pos]) {
+                case '\b': writer.push("\\b"); break;
+                case '\f': writer.push("\\f"); break;
+                case '\n': writer.push("\\n"); break;
+                case '\r': writer.push("\\r"); break;
+                case '\t': writer.push("\\t"); break;
+                case '/': writer.push('/'); break;
+                case '\"': writer.push("\\\""); break;
+                case '\\': writer.push("\\\\"); break;
+                default: {
+                    if (str[pos] < 0x20) {
+                        pos += stringify_utf8(writer, str.data() + pos,
+                                              str.size() - pos);
+                        --pos;
+                    } else {
+                        writer.push(str[pos]);
+                    }
+                } break;
+            }
+            ++pos;
+        }
+        writer.push('\"');
+    }
+
+    void stringify_string(Writer &writer) const {
+        stringify_string_raw(writer, str_view());
+    }
+
+private:
+    // ---- 节点的存储布局 ----
+    // 默认是 16 字节的带标签 union; 定义 ZJSON_NAN_BOXING 时改用 8 字节的
+    // NaN-boxing. 两种布局提供同一组读写函数, 其余代码只通过它们访问节点
+
+#if defined(ZJSON_NAN_BOXING)
+    // double 按原样存放 (NaN 统一成 kCanonicalNaN), 其余类型占用负的 quiet NaN
+    // 空间: 高 13 位全 1, 第 48~50 位为标签, 低 48 位为载荷. 指针载荷的低 2 位
+    // 用作标记: bit0 表示内存在 arena 中, bit1 表示 kArena 字符串.
+    // 放不进 48 位的整数和带长度的字符串视图另行分配一个小块存放
+    enum Tag : uint64_t {
+        kTagSpecial,  // 载荷 0: null, 1: false, 2: true
+        kTagInt,      // 48 位有符号整数
+        kTagBoxed,    // IntegerBox *
+        kTagString,   // String *
+        kTagView,     // StringRef *
+        kTagArray,    // SharedArray *
+        kTagObject,   // SharedObject *
+        kTagInline    // 短字符串, 见 set_inline
+    };
+
+    static_assert(std::is_same<Number, double>::value,
+                  "ZJSON_NAN_BOXING 要求 Number 为 double");
+
+    static constexpr uint64_t kBoxed = 0xFFF8000000000000;
+    static constexpr uint64_t kPayloadMask = (uint64_t(1) << 48) - 1;
+    static constexpr uint64_t kCanonicalNaN = 0x7FF8000000000000;
+    static constexpr uint64_t kInArena = 1;
+    static constexpr uint64_t kArenaString = 2;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static constexpr size_t kInlineCapacity = 0;
+#else
+    static constexpr size_t kInlineCapacity = 5;
+#endif
+
+    struct IntegerBox {
+        Kind kind;
+        Uint64 value;  // kInt64 按补码存放
+    };
+
+    struct StringRef {
+        const char *data;
+        size_t size;
+    };
+
+    bool is_boxed() const { return bits_ >= kBoxed; }
+    uint64_t tag() const { return (bits_ >> 48) & 7; }
+    uint64_t payload() const { return bits_ & kPayloadMask; }
+
+    template <typename T>
+    T *pointer() const {
+        return (T *)uintptr_t(payload() & ~uint64_t(3));
+    }
+
+    void box(uint64_t tag, uint64_t payload) {
+        bits_ = kBoxed | tag << 48 | payload;
+    }
+
+    // 载荷只有 48 位, 只支持不超过 48 位的用户态地址. 开启 5 级页表 (LA57)
+    // 或 52 位虚拟地址的系统可能把内存分配到更高处, 此时直接终止, 而不是
+    // 截断指针后在别处解引用
+    void box(uint64_t tag, const void *p, uint64_t flags) {
+        if (uint64_t(uintptr_t(p)) > kPayloadMask) std::abort();
+        assert((uintptr_t(p) & 3) == 0);
+        box(tag, uint64_t(uintptr_t(p)) | flags);
+    }
+
+    template <typename T, typename... Args>
+    static T *create(detail::Arena *arena, Args &&...args) {
+        if (!arena) return construct<T>(std::forward<Args>(args)...);
+        void *p = arena->allocate(sizeof(T), alignof(T));
+        return new (p) T{std::forward<Args>(args)...};
+    }
+
+    Type type() const {
+        static constexpr Type kTagTypes[] = {
+            Type::kBoolean, Type::kNumber, Type::kNumber, Type::kString,
+            Type::kString,  Type::kArray,  Type::kObject, Type::kString};
+        if (!is_boxed()) return Type::kNumber;
+        if (bits_ == kBoxed) return Type::kNull;
+        return kTagTypes[tag()];
+    }
+
+    Kind kind() const {
+        if (!is_boxed()) return Kind::kDefault;
+        switch (tag()) {
+            case kTagInt: return Kind::kInt64;
+            case kTagBoxed: return pointer<IntegerBox>()->kind;
+            case kTagView:
+                return payload() & kArenaString ? Kind::kArena : Kind::kView;
+            case kTagArray:
+            case kTagObject:
+                return payload() & kInArena ? Kind::kArena : Kind::kDefault;
+            case kTagInline: return Kind::kInline;
+            default: return Kind::kDefault;
+        }
+    }
+
+    Boolean boolean() const { return payload() == 2; }
+
+    Number number() const {
+        Number d;
+        memcpy(&d, &bits_, sizeof(d));
+        return d;
+    }
+
+    Int64 int64() const {
+        if (tag() == kTagInt) return Int64(bits_ << 16) >> 16;
+        return Int64(pointer<IntegerBox>()->value);
+    }
+
+    Uint64 uint64() const { return pointer<IntegerBox>()->value; }
+    String *str() const { return pointer<String>(); }
+    SharedArray *shared_array() const { return pointer<SharedArray>(); }
+    SharedObject *shared_object() const { return pointer<SharedObject>(); }
+
+    std::string_view view() const {
+        if (tag() == kTagInline) {
+            return {(const char *)&bits_,
+                    kInlineCapacity - ((bits_ >> 40) & 0xFF)};
+        }
+        StringRef *ref = pointer<StringRef>();
+        return {ref->data, ref->size};
+    }
+
+    void set_null() { box(kTagSpecial, 0); }
+    void set_boolean(Boolean b) { box(kTagSpecial, b ? 2 : 1); }
+
+    void set_number(Number d) {
+        if (std::isnan(d)) {
+            bits_ = kCanonicalNaN;
+        } else {
+            memcpy(&bits_, &d, sizeof(d));
+        }
+    }
+
+    void set_int64(Int64 v, detail::Arena *arena = nullptr) {
+        if (v >= -(Int64(1) << 47) && v < (Int64(1) << 47)) {
+            box(kTagInt, Uint64(v) & kPayloadMask);
+        } else {
+            box(kTagBoxed, create<IntegerBox>(arena, Kind::kInt64, Uint64(v)),
+                arena ? kInArena : 0);
+        }
+    }
+
+    void set_uint64(Uint64 v, detail::Arena *arena = nullptr) {
+        box(kTagBoxed, create<IntegerBox>(arena, Kind::kUint64, v),
+            arena ? kInArena : 0);
+    }
+
+    void set_string(String *str) { box(kTagString, str, 0); }
+
+    bool set_view(std::string_view sv, Kind kind,
+                  detail::Arena *arena = nullptr) {
+        StringRef *ref = create<StringRef>(arena, sv.data(), sv.size());
+        box(kTagView, ref,
+            (arena ? kInArena : 0) | (kind == Kind::kArena ? kArenaString : 0));
+        return true;
+    }
+
+    // 小端序下载荷的低 5 字节即 bits_ 的前 5 个字节, 存放字符串内容, 第 6 字节
+    // 存剩余容量 (存满时正好是 '\0'). 大端序时只内联空串
+    bool set_inline(std::string_view sv) {
+        if (sv.size() > kInlineCapacity) return false;
+        uint64_t chars = 0;
+        memcpy(&chars, sv.data(), sv.size());
+        box(kTagInline, chars | uint64_t(kInlineCapacity - sv.size()) << 40);
+        return true;
+    }
+
+    void set_array(SharedArray *array, Kind kind = Kind::kDefault) {
+        box(kTagArray, array, kind == Kind::kArena ? kInArena : 0);
+    }
+
+    void set_object(SharedObject *object, Kind kind = Kind::kDefault) {
+        box(kTagObject, object, kind == Kind::kArena ? kInArena : 0);
+    }
+
+    void release() {
+        if (!is_boxed() || payload() & kInArena) return;
+        switch (tag()) {
+            case kTagBoxed: destroy(pointer<IntegerBox>()); break;
+            case kTagString: destroy(pointer<String>()); break;
+            case kTagView: destroy(pointer<StringRef>()); break;
+            case kTagArray: unshare(pointer<SharedArray>()); break;
+            case kTagObject: unshare(pointer<SharedObject>()); break;
+            default: break;
+        }
+    }
+
+    void move(BasicJson &other) {
+        bits_ = other.bits_;
+        other.set_null();
+    }
+
+    uint64_t bits_;
+};
+
+static_assert(sizeof(Json) == 8, "NaN-boxed Json node should be 8 bytes");
+#else
+    static constexpr size_t kInlineCapacity = 13;
+
+    Type type() const { return node_.type; }
+    Kind kind() const { return node_.kind; }
+    Boolean boolean() const { return node_.value.boolean; }
+    Number number() const { return node_.value.number; }
+    Int64 int64() const { return node_.value.int64; }
+    Uint64 uint64() const { return node_.value.uint64; }
+    String *str() const { return node_.value.str; }
+    SharedArray *shared_array() const { return node_.value.array; }
+    SharedObject *shared_object() const { return node_.value.object; }
+
+    std::string_view view() const {
+        if (node_.kind == Kind::kInline) {
+            size_t spare = size_t(small_.data[kInlineCapacity]);
+            return {small_.data, kInlineCapacity - spare};
+        }
+        return {node_.value.view, node_.size};
+    }
+
+    void set(Type type, Kind kind = Kind::kDefault) {
+        node_.type = type;
+        node_.kind = kind;
+    }
+
+    void set_null() {
+        set(Type::kNull);
+        node_.value.uint64 = 0;
+    }
+
+    void set_boolean(Boolean b) {
+        set(Type::kBoolean);
+        node_.value.boolean = b;
+    }
+
+    void set_number(Number d) {
+        set(Type::kNumber);
+        node_.value.number = d;
+    }
+
+    void set_int64(Int64 v, detail::Arena * = nullptr) {
+        set(Type::kNumber, Kind::kInt64);
+        node_.value.int64 = v;
+    }
+
+    void set_uint64(Uint64 v, detail::Arena * = nullptr) {
+        set(Type::kNumber, Kind::kUint64);
+        node_.value.uint64 = v;
+    }
+
+    void set_string(String *str) {
+        set(Type::kString);
+        node_.value.str = str;
+    }
+
+    // 长度放不进 node_.size 时返回 false, 由调用方改存为 String
+    bool set_view(std::string_view sv, Kind kind, detail::Arena * = nullptr) {
+        if (sv.size() > UINT32_MAX) return false;
+        set(Type::kString, kind);
+        node_.value.view = sv.data();
+        node_.size = uint32_t(sv.size());
+        return true;
+    }
+
+    bool set_inline(std::string_view sv) {
+        if (sv.size() > kInlineCapacity) return false;
+        small_.type = Type::kString;
+        small_.kind = Kind::kInline;
+        memcpy(small_.data, sv.data(), sv.size());
+        memset(small_.data + sv.size(), 0, kInlineCapacity - sv.size());
+        small_.data[kInlineCapacity] = char(kInlineCapacity - sv.size());
+        return true;
+    }
+
+    void set_array(SharedArray *array, Kind kind = Kind::kDefault) {
+        set(Type::kArray, kind);
+        node_.value.array = array;
+    }
+
+    void set_object(SharedObject *object, Kind kind = Kind::kDefault) {
+        set(Type::kObject, kind);
+        node_.value.object = object;
+    }
+
+    void release() {
+        if (node_.kind != Kind::kDefault) return;
+        switch (node_.type) {
+            case Type::kString: destroy(node_.value.str); break;
+            case Type::kArray: unshare(node_.value.array); break;
+            case Type::kObject: unshare(node_.value.object); break;
+            default: break;
+        }
+    }
+
+    void move(BasicJson &other) {
+        if (other.node_.kind == Kind::kInline) {
+            small_ = other.small_;
+        } else {
+            node_ = other.node_;
+        }
+        other.set_null();
+    }
+
+    struct Node {
+        Type type;
+        Kind kind;
+        uint32_t size;  // kView/kArena 字符串的长度
+        Value value;
+    };
+
+    // kInline 的短字符串直接存在节点里. 末字节存剩余容量, 存满时它正好是 '\0',
+    // 所以内联的字符串总以 '\0' 结尾
+    struct Small {
+        Type type;
+        Kind kind;
+        char data[kInlineCapacity + 1];
+    };
+
+    // 两者开头的 type/kind 相同, 可以通过任一成员读取
+    union {
+        Node node_;
+        Small small_;
+    };
+};
+
+// 数组元素即节点本身, 保持 16 字节: 类型 + Kind + 字符串长度 + 8 字节的值,
+// 或类型 + Kind + 14 字节的内联字符串
+static_assert(sizeof(Json) == 16, "Json node should stay 16 bytes");
+#endif
+
+// 按需解析的只读游标: 只解析访问路径上的值, 途经但未访问的值按括号匹配整段跳过,
+// 只检查跳过所需的结构. 游标直接引用 text, text 需在游标使用期间保持有效.
+// 途中的格式错误抛出 ParseError, 位置相对整个 text; find, tryGet 和
+// tryToJson 不抛出异常
+class Cursor {
+public:
+    explicit Cursor(std::string_view text)
+        : Cursor(text.data(), text.data(), text.data() + text.size()) {
+        if (pos_ == end_) {
+            ZJSON_THROW(ParseError(
+                ParseResult::at(Ret::kParseExpectValue, begin_, end_, end_)));
+        }
+    }
+
+    // 不抛出异常的构造: text 为空或只有空白时返回空
+    static std::optional<Cursor> tryOpen(std::string_view text) {
+        Cursor cursor(text.data(), text.data(), text.data() + text.size());
+        if (cursor.pos_ == cursor.end_) return std::nullopt;
+        return cursor;
+    }
+
+    Type getType() const {
+        switch (*pos_) {
+            case 'n': return Type::kNull;
+            case 't':
+            case 'f': return Type::kBoolean;
+            case '\"': return Type::kString;
+            case '[': return Type::kArray;
+            case '{': return Type::kObject;
+            default: return Type::kNumber;
+        }
+    }
+
+    bool isNull() const { return getType() == Type::kNull; }
+    bool isBoolean() const { return getType() == Type::kBoolean; }
+    bool isNumber() const { return getType() == Type::kNumber; }
+    bool isString() const { return getType() == Type::kString; }
+    bool isArray() const { return getType() == Type::kArray; }
+    bool isObject() const { return getType() == Type::kObject; }
+
+    // 与 Json 一样, 类型不符时抛出 std::runtime_error, 越界或没有该键时抛出
+    // std::out_of_range
+    Cursor operator[](size_t idx) const {
+        check_type(Type::kArray, "array");
+        Failure failure;
+        const char *value = element(idx, failure);
+        if (failure.ret != Ret::kParseOk) parse_error(failure);
+        if (!value) ZJSON_THROW(std::out_of_range("array index out of range!"));
+        return Cursor(begin_, value, end_);
+    }
+
+    Cursor operator[](std::string_view key) const {
+        check_type(Type::kObject, "object");
+        Failure failure;
+        const char *value = member(key, failure);
+        if (failure.ret != Ret::kParseOk) parse_error(failure);
+        if (!value) ZJSON_THROW(std::out_of_range("key not found!"));
+        return Cursor(begin_, value, end_);
+    }
+
+    // 不是数组/对象, 越界, 没有该键或途中的文本有误时返回空
+    std::optional<Cursor> find(size_t idx) const {
+        if (getType() != Type::kArray) return std::nullopt;
+        Failure failure;
+        const char *value = element(idx, failure);
+        if (!value) return std::nullopt;
+        return Cursor(begin_, value, end_);
+    }
+
+    std::optional<Cursor> find(std::string_view key) const {
+        if (getType() != Type::kObject) return std::nullopt;
+        Failure failure;
+        const char *value = member(key, failure);
+        if (!value) return std::nullopt;
+        return Cursor(begin_, value, end_);
+    }
+
+    bool contains(std::string_view key) const { return find(key).has_value(); }
+
+    bool contain(std::string_view key) const {
+        check_type(Type::kObject, "object");
+        Failure failure;
+        const char *value = member(key, failure);
+        if (failure.ret != Ret::kParseOk) parse_error(failure);
+        return value != nullptr;
+    }
+
+    // 标量直接就地解析; 取 Array/Object 时会完整解析该子树. 解析出的 Json
+    // 是临时的, 所以不能按 std::string_view 取出
+    template <typename T>
+    T get() const {
+        static_assert(!std::is_same<T, std::string_view>::value,
+                      "get<T>: the view would outlive the parsed value");
+        return toJson().get<T>();
+    }
+
+    // 不抛出异常的 get: 文本有误或类型不符时返回 std::nullopt
+    template <typename T>
+    std::optional<T> tryGet() const {
+        static_assert(!std::is_same<T, std::string_view>::value,
+                      "tryGet<T>: the view would outlive the parsed value");
+        Json json;
+        if (!tryToJson(json)) return std::nullopt;
+        return json.tryGet<T>();
+    }
+
+    Json toJson() const {
+        Json json;
+        ParseResult result = tryToJson(json);
+        if (!result) ZJSON_THROW(ParseError(result));
+        return json;
+    }
+
+    // 完整解析游标处的值, 失败时 json 为 null
+    ParseResult tryToJson(Json &json) const {
+        json.clear();
+        detail::TextSource source{pos_, end_};
+        const char *error = nullptr;
+        Ret ret = json.parse_value<false>(source, Json::kDefaultMaxDepth,
+                                          nullptr, nullptr, &error);
+        if (ret == Ret::kParseOk && source.text != end_ &&
+            !detail::is_structural_or_whitespace(*source.text)) {
+            json.clear();
+            ret = Ret::kParseInvalidValue;
+            error = source.text;
+        }
+        return ParseResult::at(ret, begin_, end_, error);
+    }
+
+private:
+    // 查找途中的格式错误, pos 为出错处
+    struct Failure {
+        Ret ret = Ret::kParseOk;
+        const char *pos = nullptr;
+    };
+
+    Cursor(const char *begin, const char *pos, const char *end)
+        : begin_(begin), pos_(skip_whitespace(pos, end)), end_(end) {}
+
+    [[noreturn]] void parse_error(const Failure &failure) const {
+        ZJSON_THROW(ParseError(
+            ParseResult::at(failure.ret, begin_, end_, failure.pos)));
+    }
+
+    static const char *fail(Failure &failure, Ret ret, const char *pos) {
+        failure = {ret, pos};
+        return nullptr;
+    }
+
+    void check_type(Type type, const char *msg) const {
+        if (getType() != type) {
+            std::string error_msg =
+                std::string("text value isn't' ") + msg + "!";
+            ZJSON_THROW(std::runtime_error(error_msg));
+        }
+    }
+
+    static const char *skip_whitespace(const char *p, const char *end) {
+        while (p != end && detail::is_whitespace(*p)) ++p;
+        return p;
+    }
+
+    const char *skip_whitespace(const char *p) const {
+        return skip_whitespace(p, end_);
+    }
+
+    // p 指向开头引号之后, 返回结尾引号之后
+    const char *skip_string(const char *p, Failure &failure) const {
+        for (;;) {
+            p = detail::scan_string(p, end_);
+            if (p == end_ || (*p == '\\' && end_ - p < 2)) {
+                return fail(failure, Ret::kParseMissQuotationMark, end_);
+            }
+            if (*p == '\"') return p + 1;
+            p += *p == '\\' ? 2 : 1;
+        }
+    }
+
+    // p 指向值的首字节, 返回值之后的位置
+    const char *skip_value(const char *p, Failure &failure) const {
+        switch (*p) {
+            case '\"': return skip_string(p + 1, failure);
+            case '[':
+            case '{': break;
+            default:
+                while (p != end_ && !detail::is_structural_or_whitespace(*p)) {
+                    ++p;
+                }
+                return p;
+        }
+        Ret unclosed = *p == '[' ? Ret::kParseMissCommaOrSquareBracket
+                                 : Ret::kParseMissCommaOrCurlyBracket;
+        size_t depth = 1;
+        ++p;
+        for (;;) {
+            p = detail::scan_bracket(p, end_);
+            if (p == end_) return fail(failure, unclosed, end_);
+            char ch = *p++;
+            if (ch == '\"') {
+                p = skip_string(p, failure);
+                if (!p) return nullptr;
+            } else if (ch == '[' || ch == '{') {
+                ++depth;
+            } else if (--depth == 0) {
+                return p;
+            }
+        }
+    }
+
+    // 比较 p 处的键与 key, 返回结尾引号之后. 不含转义的键直接比较原文
+    const char *match_key(const char *p, std::string_view key, bool &match,
+                          Failure &failure) const {
+        const char *begin = p + 1;
+        const char *q = detail::scan_string(begin, end_);
+        if (q != end_ && *q == '\"') {
+            match = std::string_view(begin, q - begin) == key;
+            return q + 1;
+        }
+        const char *start = p;
+        Json::String str;
+        if (Json::parse_string_raw(p, end_, str) != Ret::kParseOk) {
+            return fail(failure, Ret::kParseMissKey, start);
+        }
+        match = str == key;
+        return p;
     }
 
-    int stringify_utf8(const char *str) {
-        char ch = *str++;
-        int count = 1;
-        if ((ch & 0xF0) == 0xF0) {
-            count = 4;
-        } else if ((ch & 0xE0) == 0xE0) {
-            count = 3;
-        } else if ((ch & 0xC0) == 0xC0) {
-            count = 2;
+    // 返回第 idx 个元素的首字节; 越界或出错时返回 nullptr, 出错时另记下原因
+    const char *element(size_t idx, Failure &failure) const {
+        const char *p = skip_whitespace(pos_ + 1);
+        if (p == end_) {
+            return fail(failure, Ret::kParseMissCommaOrSquareBracket, p);
         }
-        int code = ((ch << count) & 0xFF) >> count;
-        for (int i = 1; i < count; ++i) {
-            code = (code << 6) + (*str++ & 0x3F);
+        if (*p == ']') return nullptr;
+        for (size_t i = 0; i != idx; ++i) {
+            p = skip_value(p, failure);
+            if (!p) return nullptr;
+            p = skip_whitespace(p);
+            if (p != end_ && *p == ']') return nullptr;
+            if (p == end_ || *p != ',') {
+                return fail(failure, Ret::kParseMissCommaOrSquareBracket, p);
+            }
+            p = skip_whitespace(p + 1);
+            if (p == end_) return fail(failure, Ret::kParseExpectValue, p);
+            if (*p == ']') return fail(failure, Ret::kParseInvalidValue, p);
         }
-        if (code < 0x10000) {
-            stack_push("\\u");
-            stringify_hex4(code);
+        return p;
+    }
+
+    // 返回 key 对应值的首字节; 不存在或出错时返回 nullptr
+    const char *member(std::string_view key, Failure &failure) const {
+        const char *p = skip_whitespace(pos_ + 1);
+        if (p != end_ && *p == '}') return nullptr;
+        for (;;) {
+            if (p == end_ || *p != '\"') {
+                return fail(failure, Ret::kParseMissKey, p);
+            }
+            bool match = false;
+            p = match_key(p, key, match, failure);
+            if (!p) return nullptr;
+            p = skip_whitespace(p);
+            if (p == end_ || *p != ':') {
+                return fail(failure, Ret::kParseMissColon, p);
+            }
+            p = skip_whitespace(p + 1);
+            if (p == end_) return fail(failure, Ret::kParseExpectValue, p);
+            if (match) return p;
+            p = skip_value(p, failure);
+            if (!p) return nullptr;
+            p = skip_whitespace(p);
+            if (p != end_ && *p == '}') return nullptr;
+            if (p == end_ || *p != ',') {
+                return fail(failure, Ret::kParseMissCommaOrCurlyBracket, p);
+            }
+            p = skip_whitespace(p + 1);
+        }
+    }
+
+    const char *begin_;  // 整个 text 的开头, 用于换算出错的位置
+    const char *pos_;
+    const char *end_;
+};
+
+// 所有容器和字符串都分配在自带 arena 中的文档, 销毁或重新解析时整块释放,
+// 不再逐个析构节点. 树只读; 拷贝出的 Json 与 Document 无关, 可以任意修改.
+// 键放在键表中, 每个不同的键只存一份; 键表跨多次 parse 复用, 不同的键超过
+// kMaxKeys 个或共占 kMaxKeyBytes 字节以上时才在下次解析前清空
+template <typename Traits>
+class BasicDocument {
+public:
+    using Json = BasicJson<Traits>;
+
+    inline static const size_t kMaxKeys = 1 << 16;
+    inline static const size_t kMaxKeyBytes = 1 << 24;
+
+    BasicDocument() = default;
+    // arena 和键表的内存块都从 upstream 申请
+    explicit BasicDocument(std::pmr::memory_resource *upstream)
+        : arena_(upstream), keys_(upstream) {}
+    BasicDocument(const BasicDocument &) = delete;
+    BasicDocument &operator=(const BasicDocument &) = delete;
+
+    void parse(std::string_view text, Engine engine = Engine::kOnePass,
+               size_t max_depth = Json::kDefaultMaxDepth) {
+        ParseResult result = tryParse(text, engine, max_depth);
+        if (!result) ZJSON_THROW(ParseError(result));
+    }
+
+    // 同 Json::parseInsitu: 字符串直接引用 text, 其余部分放在 arena 中
+    void parseInsitu(char *text, size_t len, Engine engine = Engine::kOnePass,
+                     size_t max_depth = Json::kDefaultMaxDepth) {
+        ParseResult result = tryParseInsitu(text, len, engine, max_depth);
+        if (!result) ZJSON_THROW(ParseError(result));
+    }
+
+    // 不抛出异常的版本, 失败时根节点为 null
+    ParseResult tryParse(std::string_view text,
+                         Engine engine = Engine::kOnePass,
+                         size_t max_depth = Json::kDefaultMaxDepth) {
+        return parse_root<false>(text.data(), text.data() + text.size(),
+                                 engine, max_depth);
+    }
+
+    ParseResult tryParseInsitu(char *text, size_t len,
+                               Engine engine = Engine::kOnePass,
+                               size_t max_depth = Json::kDefaultMaxDepth) {
+        return parse_root<true>(text, text + len, engine, max_depth);
+    }
+
+    const Json &root() const { return root_; }
+
+    // 键表中不同的键的个数, 以及它们共占的字节数
+    size_t keyCount() const { return keys_.size(); }
+    size_t keyBytes() const { return keys_.bytes(); }
+
+private:
+    template <bool kInsitu>
+    ParseResult parse_root(const char *begin, const char *end, Engine engine,
+                           size_t max_depth) {
+        root_.clear();
+        arena_.reset();
+        if (keys_.size() > kMaxKeys || keys_.bytes() > kMaxKeyBytes) {
+            keys_.clear();
+        }
+        return root_.template parse_root<kInsitu>(begin, end, engine,
+                                                  max_depth, &arena_, &keys_);
+    }
+
+    detail::Arena arena_;
+    detail::KeyTable keys_;
+    Json root_;
+};
+
+using Document = BasicDocument<JsonTraits>;
+using PmrDocument = BasicDocument<PmrJsonTraits>;
+
+// RFC 6901 JSON Pointer, 如 "/spec/containers/0/image". 构造时解析一次:
+// 各段反转义 (~1 为 '/', ~0 为 '~') 后连续存放并算好哈希, 可作数组下标的段
+// 预先转为整数. 之后对任意多个 Json 求值都只是逐段查找, 不分配内存.
+// 空串指向根; 数组中的 "-" 指向末尾元素之后, 只能用于 set 追加
+class JsonPointer {
+public:
+    JsonPointer() = default;
+
+    explicit JsonPointer(std::string_view path) {
+        if (!assign(path)) {
+            ZJSON_THROW(std::invalid_argument("invalid json pointer!"));
+        }
+    }
+
+    // 不抛出异常的版本: 非空且不以 '/' 开头, 或 '~' 后不是 0/1 时返回空
+    static std::optional<JsonPointer> tryParse(std::string_view path) {
+        JsonPointer pointer;
+        if (!pointer.assign(path)) return std::nullopt;
+        return pointer;
+    }
+
+    // 段数与反转义后的第 idx 段
+    size_t size() const { return tokens_.size(); }
+    std::string_view operator[](size_t idx) const { return key(tokens_[idx]); }
+
+    // 重新转义后的路径
+    std::string str() const {
+        std::string path;
+        for (const Token &token : tokens_) {
+            path += '/';
+            for (char ch : key(token)) {
+                if (ch == '~') {
+                    path += "~0";
+                } else if (ch == '/') {
+                    path += "~1";
+                } else {
+                    path += ch;
+                }
+            }
+        }
+        return path;
+    }
+
+    // 所指的值, 不存在时返回空指针. 非 const 版本只在找到时才让沿途的节点
+    // 独占载荷
+    template <typename Traits>
+    const BasicJson<Traits> *find(const BasicJson<Traits> &root) const {
+        const BasicJson<Traits> *node = &root;
+        for (const Token &token : tokens_) {
+            node = step(node, token);
+            if (!node) return nullptr;
+        }
+        return node;
+    }
+
+    template <typename Traits>
+    BasicJson<Traits> *find(BasicJson<Traits> &root) const {
+        if (!find(std::as_const(root))) return nullptr;
+        BasicJson<Traits> *node = &root;
+        for (const Token &token : tokens_) node = step(node, token);
+        return node;
+    }
+
+    template <typename Traits>
+    const BasicJson<Traits> &get(const BasicJson<Traits> &root) const {
+        const BasicJson<Traits> *node = find(root);
+        if (!node) ZJSON_THROW(std::out_of_range("json pointer not found!"));
+        return *node;
+    }
+
+    // 把 value 写到所指处并返回它. 缺少的对象成员会被创建, null 当作空对象;
+    // 数组下标须已存在, 或为 "-"/数组长度时追加到末尾. 路径经过标量或
+    // 越界的下标时不做修改, 返回空指针
+    template <typename Traits>
+    BasicJson<Traits> *set(BasicJson<Traits> &root,
+                           BasicJson<Traits> value) const {
+        using Json = BasicJson<Traits>;
+        Json *node = &root;
+        for (const Token &token : tokens_) {
+            if (node->isArray()) {
+                typename Json::Array &array =
+                    node->template getRef<typename Json::Array>();
+                if (token.index < array.size()) {
+                    node = &array[token.index];
+                } else if (token.index == array.size() ||
+                           token.index == kAppend) {
+                    node = &array.emplace_back();
+                } else {
+                    return nullptr;
+                }
+            } else if (node->isObject() || node->isNull()) {
+                Json *member = node->find(hashed(token));
+                node = member ? member : &(*node)[key(token)];
+            } else {
+                return nullptr;
+            }
+        }
+        *node = std::move(value);
+        return node;
+    }
+
+    // 删除所指的值, 不存在时返回 false. 空路径把根置为 null
+    template <typename Traits>
+    bool erase(BasicJson<Traits> &root) const {
+        using Json = BasicJson<Traits>;
+        if (tokens_.empty()) {
+            root.clear();
+            return true;
+        }
+        const Token &last = tokens_.back();
+        const Json *parent = &root;
+        for (size_t i = 0; i + 1 < tokens_.size() && parent; ++i) {
+            parent = step(parent, tokens_[i]);
+        }
+        if (!parent || !step(parent, last)) return false;
+
+        Json *node = &root;
+        for (size_t i = 0; i + 1 < tokens_.size(); ++i) {
+            node = step(node, tokens_[i]);
+        }
+        if (node->isArray()) {
+            typename Json::Array &array =
+                node->template getRef<typename Json::Array>();
+            array.erase(array.begin() + last.index);
         } else {
-            code &= 0xFFFF;
-            int H = code / 0x400 + 0xD800;
-            int L = code % 0x400 + 0xDC00;
-            stack_push("\\u");
-            stringify_hex4(H);
-            stack_push("\\u");
-            stringify_hex4(L);
+            node->template getRef<typename Json::Object>().erase(key(last));
         }
-        return count;
+        return true;
     }
 
-    char *stringify_string_raw(const char *str, int len) {
-        size_t old_top = stack_.size();
-        stack_push("\"");
-        int pos = 0;
-        while (pos < len) {
-            switch (str[pos]) {
-                case '\b': stack_push("\\b"); break;
-                case '\f': stack_push("\\f"); break;
-                case '\n': stack_push("\\n"); break;
-                case '\r': stack_push("\\r"); break;
-                case '\t': stack_push("\\t"); break;
-                case '/': stack_push("/"); break;
-                case '\"': stack_push("\\\""); break;
-                case '\\': stack_push("\\\\"); break;
-                default: {
-                    if (str[pos] < 0x20) {
-                        pos += stringify_utf8(str + pos);
-                        --pos;
-                    } else {
-                        stack_push(str[pos]);
+private:
+    static constexpr size_t kNotIndex = size_t(-1);
+    static constexpr size_t kAppend = size_t(-2);
+
+    struct Token {
+        size_t offset;  // 在 text_ 中的位置
+        size_t length;
+        size_t hash;
+        size_t index;  // 数组下标, 或 kNotIndex/kAppend
+    };
+
+    std::string_view key(const Token &token) const {
+        return {text_.data() + token.offset, token.length};
+    }
+
+    HashedKey hashed(const Token &token) const {
+        return HashedKey(key(token), token.hash);
+    }
+
+    // 沿一段前进一层, 不存在时返回空指针
+    template <typename J>
+    J *step(J *node, const Token &token) const {
+        if (node->isObject()) return node->find(hashed(token));
+        if (node->isArray() && token.index < node->size()) {
+            return node->find(token.index);
+        }
+        return nullptr;
+    }
+
+    bool assign(std::string_view path) {
+        text_.clear();
+        tokens_.clear();
+        if (path.empty()) return true;
+        if (path[0] != '/') return false;
+        text_.reserve(path.size());
+        size_t pos = 1;
+        for (;;) {
+            size_t next = std::min(path.find('/', pos), path.size());
+            Token token{text_.size(), 0, 0, kNotIndex};
+            for (size_t i = pos; i < next; ++i) {
+                char ch = path[i];
+                if (ch == '~') {
+                    if (++i == next || (path[i] != '0' && path[i] != '1')) {
+                        return false;
+                    }
+                    ch = path[i] == '0' ? '~' : '/';
+                }
+                text_ += ch;
+            }
+            token.length = text_.size() - token.offset;
+            std::string_view k = key(token);
+            token.hash = std::hash<std::string_view>()(k);
+            token.index = to_index(k);
+            tokens_.push_back(token);
+            if (next == path.size()) return true;
+            pos = next + 1;
+        }
+    }
+
+    // "0" 或不以 0 开头的十进制数
+    static size_t to_index(std::string_view token) {
+        if (token == "-") return kAppend;
+        if (token.empty() || (token[0] == '0' && token.size() > 1)) {
+            return kNotIndex;
+        }
+        size_t index = 0;
+        auto [end, ec] =
+            std::from_chars(token.data(), token.data() + token.size(), index);
+        if (ec != std::errc() || end != token.data() + token.size() ||
+            index >= kAppend) {
+            return kNotIndex;
+        }
+        return index;
+    }
+
+    std::string text_;
+    std::vector<Token> tokens_;
+};
+
+class TapeRef;
+
+// 只读文档的扁平表示: 整个文档是一条 64 位记录组成的 tape 加一块字符串缓冲,
+// 共两次分配, 重新解析时复用原有容量. 每条记录的高 8 位为标签, 低 56 位为载荷:
+//   'n' 't' 'f'       null/true/false
+//   'l' 'u' 'd'       int64/uint64/double, 值存在紧随的下一条记录中
+//   '"'               字符串, 载荷为其在缓冲中的偏移,
+//                     该处为 8 字节长度 + 内容 + '\0'
+//   '[' '{'           容器开始, 载荷为对应结束记录的下一条的下标
+//   ']' '}'           容器结束, 载荷为成员个数
+// 对象的成员按 键, 值 依次存放, 重复的键与 Json 一样只保留第一个.
+// 遍历即顺序读内存, 跳过子树只需读开始记录
+class Tape {
+public:
+    Tape() = default;
+
+    void parse(std::string_view text, Engine engine = Engine::kOnePass,
+               size_t max_depth = Json::kDefaultMaxDepth) {
+        ParseResult result = tryParse(text, engine, max_depth);
+        if (!result) ZJSON_THROW(ParseError(result));
+    }
+
+    // 不抛出异常的 parse: 失败时 tape 中只有一个 null, 返回值给出原因和
+    // 出错的位置
+    ParseResult tryParse(std::string_view text,
+                         Engine engine = Engine::kOnePass,
+                         size_t max_depth = Json::kDefaultMaxDepth) {
+        const char *begin = text.data();
+        const char *end = begin + text.size();
+        tape_.clear();
+        strings_.clear();
+        open_.clear();
+        error_ = nullptr;
+        Ret ret;
+        if (engine == Engine::kTwoStage && text.size() <= UINT32_MAX) {
+            detail::StructuralIndex index;
+            index.build(begin, text.size());
+            detail::Tokens tokens{begin, end, index.begin(), index.end()};
+            ret = parse_document(tokens, max_depth);
+        } else {
+            detail::TextSource source{begin, end};
+            ret = parse_document(source, max_depth);
+        }
+        if (ret != Ret::kParseOk) {
+            tape_.clear();
+            strings_.clear();
+            push('n');
+        }
+        return ParseResult::at(ret, begin, end, error_);
+    }
+
+    TapeRef root() const;
+
+private:
+    friend class TapeRef;
+
+    static constexpr uint64_t kPayloadMask = (uint64_t(1) << 56) - 1;
+
+    static char tag(uint64_t entry) { return char(entry >> 56); }
+    static uint64_t payload(uint64_t entry) { return entry & kPayloadMask; }
+
+    void push(char tag, uint64_t payload = 0) {
+        tape_.push_back(uint64_t(uint8_t(tag)) << 56 | payload);
+    }
+
+    // 下标 i 处的值之后的第一条记录
+    size_t next(size_t i) const {
+        switch (tag(tape_[i])) {
+            case '[':
+            case '{': return payload(tape_[i]);
+            case 'l':
+            case 'u':
+            case 'd': return i + 2;
+            default: return i + 1;
+        }
+    }
+
+    std::string_view string_at(size_t i) const {
+        const char *p = strings_.data() + payload(tape_[i]);
+        uint64_t size;
+        memcpy(&size, p, sizeof(size));
+        return {p + sizeof(size), size_t(size)};
+    }
+
+    template <typename Source>
+    Ret parse_document(Source &source, size_t max_depth) {
+        Ret ret = parse_value(source, max_depth);
+        if (ret != Ret::kParseOk) return ret;
+        if ((error_ = source.peek())) return Ret::kParseRootNotSingular;
+        return ret;
+    }
+
+    // 与 Json::parse_value 同样的非递归解析, open_ 中为未闭合容器的开始记录.
+    // 出错返回时 error_ 停在出错的记号上
+    template <typename Source>
+    Ret parse_value(Source &source, size_t max_depth) {
+        const char *&text = error_;
+        for (;;) {
+            text = source.peek();
+            if (!text) return Ret::kParseExpectValue;
+            Ret ret;
+            switch (*text) {
+                case '[':
+                    if (open_.size() >= max_depth) {
+                        return Ret::kParseDepthExceeded;
+                    }
+                    source.advance();
+                    text = source.peek();
+                    if (!text) return Ret::kParseMissCommaOrSquareBracket;
+                    open_.push_back(tape_.size());
+                    push('[');
+                    if (*text != ']') continue;
+                    source.advance();
+                    close(']', 0);
+                    break;
+                case '{':
+                    if (open_.size() >= max_depth) {
+                        return Ret::kParseDepthExceeded;
+                    }
+                    source.advance();
+                    text = source.peek();
+                    if (!text) return Ret::kParseMissCommaOrCurlyBracket;
+                    open_.push_back(tape_.size());
+                    push('{');
+                    if (*text != '}') {
+                        ret = parse_member_key(source);
+                        if (ret != Ret::kParseOk) return ret;
+                        continue;
                     }
+                    source.advance();
+                    close('}', 0);
+                    break;
+                default: {
+                    text = source.begin_scalar();
+                    const char *p = text;
+                    ret = parse_scalar(p, source.end);
+                    if (ret != Ret::kParseOk) return ret;
+                    source.end_scalar(p);
                 } break;
             }
-            ++pos;
+
+            // 值已完整; 外层容器随之闭合时继续向上
+            for (;;) {
+                if (open_.empty()) return Ret::kParseOk;
+                text = source.peek();
+                if (tag(tape_[open_.back()]) == '[') {
+                    if (!text) return Ret::kParseMissCommaOrSquareBracket;
+                    if (*text == ',') {
+                        source.advance();
+                        break;
+                    } else if (*text != ']') {
+                        return Ret::kParseMissCommaOrSquareBracket;
+                    }
+                    source.advance();
+                    close(']', count(open_.back()));
+                } else {
+                    if (!text) return Ret::kParseMissCommaOrCurlyBracket;
+                    if (*text == ',') {
+                        source.advance();
+                        Ret ret = parse_member_key(source);
+                        if (ret != Ret::kParseOk) return ret;
+                        break;
+                    } else if (*text != '}') {
+                        return Ret::kParseMissCommaOrCurlyBracket;
+                    }
+                    source.advance();
+                    close('}', unique_members(open_.back()));
+                }
+            }
+        }
+    }
+
+    // 数出 start 处容器中的值 (对象的键和值各算一个)
+    size_t count(size_t start) const {
+        size_t n = 0;
+        for (size_t i = start + 1; i < tape_.size(); i = next(i)) ++n;
+        return n;
+    }
+
+    // 对象闭合前去掉重复的键, 保留先出现的, 返回余下的成员个数. 此时对象的
+    // 成员都在 tape 末尾, 去掉成员后把其后的记录前移
+    size_t unique_members(size_t start) {
+        members_.clear();
+        for (size_t i = start + 1; i < tape_.size(); i = next(i + 1)) {
+            members_.push_back(i);
+        }
+        if (!mark_duplicates()) return members_.size();
+
+        size_t out = start + 1;
+        size_t n = 0;
+        for (size_t k = 0; k < members_.size(); ++k) {
+            if (members_[k] == kDuplicate) continue;
+            out = move_records(members_[k], next(members_[k] + 1), out);
+            ++n;
+        }
+        tape_.resize(out);
+        return n;
+    }
+
+    // 把后出现的重复键在 members_ 中记为 kDuplicate, 返回是否有重复.
+    // 成员不多时两两比较, 否则按键排序后比较相邻的
+    bool mark_duplicates() {
+        static constexpr size_t kScanThreshold = 16;
+        bool found = false;
+        if (members_.size() <= kScanThreshold) {
+            for (size_t k = 1; k < members_.size(); ++k) {
+                for (size_t j = 0; j < k; ++j) {
+                    if (members_[j] != kDuplicate &&
+                        string_at(members_[j]) == string_at(members_[k])) {
+                        members_[k] = kDuplicate;
+                        found = true;
+                        break;
+                    }
+                }
+            }
+            return found;
+        }
+        keys_.clear();
+        for (size_t k = 0; k < members_.size(); ++k) {
+            keys_.emplace_back(string_at(members_[k]), k);
+        }
+        std::sort(keys_.begin(), keys_.end());
+        for (size_t k = 1; k < keys_.size(); ++k) {
+            if (keys_[k].first == keys_[k - 1].first) {
+                members_[keys_[k].second] = kDuplicate;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    // 把 [first, last) 的记录移到 out 处, 返回移动后的末尾. 其中容器开始
+    // 记录的载荷是下标, 随之减去移动的距离
+    size_t move_records(size_t first, size_t last, size_t out) {
+        uint64_t shift = first - out;
+        if (shift == 0) return last;
+        for (size_t i = first; i < last; ++i) {
+            uint64_t entry = tape_[i];
+            switch (tag(entry)) {
+                case '[':
+                case '{': entry -= shift; break;
+                case 'l':
+                case 'u':
+                case 'd': tape_[out++] = entry; entry = tape_[++i]; break;
+                default: break;
+            }
+            tape_[out++] = entry;
+        }
+        return out;
+    }
+
+    void close(char tag, size_t size) {
+        size_t start = open_.back();
+        open_.pop_back();
+        push(tag, size);
+        tape_[start] |= tape_.size();
+    }
+
+    template <typename Source>
+    Ret parse_member_key(Source &source) {
+        const char *&text = error_;
+        text = source.peek();
+        if (!text || *text != '\"') return Ret::kParseMissKey;
+        text = source.begin_scalar();
+        const char *p = text;
+        if (parse_string(p, source.end) != Ret::kParseOk) {
+            return Ret::kParseMissKey;
+        }
+        source.end_scalar(p);
+
+        text = source.peek();
+        if (!text || *text != ':') return Ret::kParseMissColon;
+        source.advance();
+        return Ret::kParseOk;
+    }
+
+    Ret parse_scalar(const char *&text, const char *end) {
+        switch (*text) {
+            case 'n': return parse_literal(text, end, Json::kLiteralNull, 'n');
+            case 't': return parse_literal(text, end, Json::kLiteralTrue, 't');
+            case 'f':
+                return parse_literal(text, end, Json::kLiteralFalse, 'f');
+            case '\"': return parse_string(text, end);
+            default: return parse_number(text, end);
+        }
+    }
+
+    Ret parse_literal(const char *&text, const char *end,
+                      std::string_view literal, char tag) {
+        for (char c : literal) {
+            if (text == end || *text++ != c) return Ret::kParseInvalidValue;
+        }
+        push(tag);
+        return Ret::kParseOk;
+    }
+
+    Ret parse_number(const char *&text, const char *end) {
+        Json::ParsedNumber n;
+        Ret ret = Json::parse_number(text, end, n);
+        if (ret != Ret::kParseOk) return ret;
+        uint64_t bits;
+        switch (n.kind) {
+            case Json::Kind::kInt64:
+                push('l');
+                bits = Json::Uint64(n.int64);
+                break;
+            case Json::Kind::kUint64:
+                push('u');
+                bits = n.uint64;
+                break;
+            default:
+                push('d');
+                memcpy(&bits, &n.number, sizeof(bits));
+                break;
+        }
+        tape_.push_back(bits);
+        return ret;
+    }
+
+    // 直接解码到缓冲末尾, 再回填长度
+    Ret parse_string(const char *&text, const char *end) {
+        size_t offset = strings_.size();
+        strings_.append(sizeof(uint64_t), '\0');
+        Ret ret = Json::parse_string_raw(text, end, strings_);
+        if (ret != Ret::kParseOk) return ret;
+        uint64_t size = strings_.size() - offset - sizeof(uint64_t);
+        memcpy(&strings_[offset], &size, sizeof(size));
+        strings_.push_back('\0');
+        push('\"', offset);
+        return ret;
+    }
+
+    static constexpr size_t kDuplicate = size_t(-1);
+
+    std::vector<uint64_t> tape_;
+    std::string strings_;
+    std::vector<size_t> open_;
+    const char *error_ = nullptr;  // 解析出错的记号, 为空表示在输入末尾
+    // 闭合对象时用的临时数组, 跨多次解析复用
+    std::vector<size_t> members_;
+    std::vector<std::pair<std::string_view, size_t>> keys_;
+};
+
+// Tape 中一个值的只读视图, 接口与 Json 的读取部分一致. 需在 Tape 下次解析
+// 或销毁前使用. 按下标访问要逐个跳过前面的元素, 完整遍历应使用迭代器
+class TapeRef {
+public:
+    // 依次访问数组的元素或对象的成员, 对象成员的键由 key() 取得
+    class Iterator {
+    public:
+        TapeRef operator*() const {
+            return TapeRef(tape_, object_ ? idx_ + 1 : idx_);
+        }
+
+        std::string_view key() const { return tape_->string_at(idx_); }
+
+        Iterator &operator++() {
+            idx_ = tape_->next(object_ ? idx_ + 1 : idx_);
+            return *this;
+        }
+
+        bool operator==(const Iterator &other) const {
+            return idx_ == other.idx_;
+        }
+        bool operator!=(const Iterator &other) const {
+            return idx_ != other.idx_;
+        }
+
+    private:
+        friend class TapeRef;
+
+        Iterator(const Tape *tape, size_t idx, bool object)
+            : tape_(tape), idx_(idx), object_(object) {}
+
+        const Tape *tape_;
+        size_t idx_;
+        bool object_;
+    };
+
+    Type getType() const {
+        switch (tag()) {
+            case 'n': return Type::kNull;
+            case 't':
+            case 'f': return Type::kBoolean;
+            case '\"': return Type::kString;
+            case '[': return Type::kArray;
+            case '{': return Type::kObject;
+            default: return Type::kNumber;
         }
-        stack_push("\"");
-        char *text = str_dup(stack_.data() + old_top, stack_.size() - old_top);
-        stack_.resize(old_top);
-        return text;
     }
 
-    char *stringify_string() {
-        return stringify_string_raw(value_.str->data(), value_.str->size());
+    bool isNull() const { return getType() == Type::kNull; }
+    bool isBoolean() const { return getType() == Type::kBoolean; }
+    bool isNumber() const { return getType() == Type::kNumber; }
+    bool isInteger() const { return tag() == 'l' || tag() == 'u'; }
+    bool isString() const { return getType() == Type::kString; }
+    bool isArray() const { return getType() == Type::kArray; }
+    bool isObject() const { return getType() == Type::kObject; }
+
+    // 数组的元素个数或对象的成员个数
+    size_t size() const {
+        if (!isArray()) check_type(Type::kObject, "array or object");
+        return Tape::payload(tape_->tape_[tape_->next(idx_) - 1]);
+    }
+
+    TapeRef operator[](size_t idx) const {
+        check_type(Type::kArray, "array");
+        size_t i = element(idx);
+        if (!i) ZJSON_THROW(std::out_of_range("array index out of range!"));
+        return TapeRef(tape_, i);
+    }
+
+    Iterator begin() const {
+        size();  // 检查类型
+        return Iterator(tape_, idx_ + 1, isObject());
+    }
+
+    Iterator end() const {
+        return Iterator(tape_, tape_->next(idx_) - 1, isObject());
+    }
+
+    bool contain(std::string_view key) const {
+        check_type(Type::kObject, "object");
+        return member(key) != 0;
+    }
+
+    TapeRef operator[](std::string_view key) const {
+        check_type(Type::kObject, "object");
+        size_t i = member(key);
+        if (!i) ZJSON_THROW(std::out_of_range("key not found!"));
+        return TapeRef(tape_, i);
+    }
+
+    // 不是数组/对象, 越界或没有该键时返回空
+    std::optional<TapeRef> find(size_t idx) const {
+        if (!isArray()) return std::nullopt;
+        size_t i = element(idx);
+        if (!i) return std::nullopt;
+        return TapeRef(tape_, i);
     }
 
-    char *stringify_array() {
-        size_t old_top = stack_.size();
-        stack_push('[');
-        auto &array = *value_.array;
-        for (size_t i = 0; i < array.size(); ++i) {
-            char *subtext = array[i].stringify();
-            stack_push(subtext);
-            free(subtext);
-            if (i != array.size() - 1) stack_push(',');
+    std::optional<TapeRef> find(std::string_view key) const {
+        if (!isObject()) return std::nullopt;
+        size_t i = member(key);
+        if (!i) return std::nullopt;
+        return TapeRef(tape_, i);
+    }
+
+    bool contains(std::string_view key) const { return find(key).has_value(); }
+
+    // 标量按 Json::get 的规则转换; 字符串还可以按 std::string_view 取出
+    template <typename T>
+    T get() const {
+        if constexpr (std::is_same<T, std::string_view>::value ||
+                      std::is_same<T, Json::String>::value) {
+            check_type(Type::kString, "String");
+            return T(tape_->string_at(idx_));
+        } else if constexpr (std::is_same<T, Json::Boolean>::value) {
+            check_type(Type::kBoolean, "Boolean");
+            return tag() == 't';
+        } else if constexpr (std::is_floating_point<T>::value) {
+            switch (tag()) {
+                case 'l': return T(Json::Int64(tape_->tape_[idx_ + 1]));
+                case 'u': return T(tape_->tape_[idx_ + 1]);
+                case 'd': {
+                    Json::Number d;
+                    memcpy(&d, &tape_->tape_[idx_ + 1], sizeof(d));
+                    return T(d);
+                }
+                default: check_type(Type::kNumber, "Number"); return T();
+            }
+        } else {
+            return scalar().get<T>();
         }
-        stack_push(']');
-        char *text = str_dup(stack_.data() + old_top, stack_.size() - old_top);
-        stack_.resize(old_top);
-        return text;
     }
 
-    char *stringify_object() {
-        size_t old_top = stack_.size();
-        stack_push('{');
-        int cnt = 0, sz = value_.object->size();
-        for (auto &[key, json] : *value_.object) {
-            char *ktext = stringify_string_raw(key.c_str(), key.size());
-            char *vtext = json.stringify();
-            stack_push(ktext);
-            stack_push(':');
-            stack_push(vtext);
-            free(ktext);
-            free(vtext);
-            if (++cnt < sz) stack_push(',');
+    // 不抛出异常的 get: 类型不符或数值不能用 T 精确表示时返回 std::nullopt
+    template <typename T>
+    std::optional<T> tryGet() const {
+        if constexpr (std::is_same<T, std::string_view>::value ||
+                      std::is_same<T, Json::String>::value) {
+            if (!isString()) return std::nullopt;
+            return T(tape_->string_at(idx_));
+        } else {
+            if (isArray() || isObject()) return std::nullopt;
+            return scalar().tryGet<T>();
         }
-        stack_push('}');
-        char *text = str_dup(stack_.data() + old_top, stack_.size() - old_top);
-        stack_.resize(old_top);
-        return text;
     }
 
 private:
-    Type type_;
+    friend class Tape;
 
-    // union {
-    //     double number;
-    //     std::string *str;
-    //     Array *array;
-    //     Object *object;
-    //     // std::multimap<std::string, Json> *object;
-    // } value_;
+    TapeRef(const Tape *tape, size_t idx) : tape_(tape), idx_(idx) {}
 
-    Value value_;
+    char tag() const { return Tape::tag(tape_->tape_[idx_]); }
 
-    mutable std::vector<char> stack_;
+    void check_type(Type type, const char *msg) const {
+        if (getType() != type) {
+            std::string error_msg =
+                std::string("text value isn't' ") + msg + "!";
+            ZJSON_THROW(std::runtime_error(error_msg));
+        }
+    }
+
+    Json scalar() const {
+        uint64_t bits = idx_ + 1 < tape_->tape_.size() ? tape_->tape_[idx_ + 1]
+                                                       : 0;
+        switch (tag()) {
+            case 'n': return Json();
+            case 't': return Json(true);
+            case 'f': return Json(false);
+            case 'l': return Json(Json::Int64(bits));
+            case 'u': return Json(Json::Uint64(bits));
+            case 'd': {
+                Json::Number d;
+                memcpy(&d, &bits, sizeof(d));
+                return Json(d);
+            }
+            case '\"': return Json(tape_->string_at(idx_));
+            default:
+                ZJSON_THROW(std::runtime_error("text value isn't' scalar!"));
+        }
+    }
+
+    // 返回第 idx 个元素的下标, 越界时返回 0
+    size_t element(size_t idx) const {
+        size_t end = tape_->next(idx_) - 1;
+        size_t i = idx_ + 1;
+        for (; i != end && idx != 0; --idx) i = tape_->next(i);
+        return i == end ? 0 : i;
+    }
+
+    // 返回 key 对应值的下标, 不存在时返回 0
+    size_t member(std::string_view key) const {
+        size_t end = tape_->next(idx_) - 1;
+        for (size_t i = idx_ + 1; i != end; i = tape_->next(i + 1)) {
+            if (tape_->string_at(i) == key) return i + 1;
+        }
+        return 0;
+    }
+
+    const Tape *tape_;
+    size_t idx_;
 };
 
+inline TapeRef Tape::root() const {
+    if (tape_.empty()) ZJSON_THROW(std::runtime_error("tape is empty!"));
+    return TapeRef(this, 0);
+}
+
 }  // namespace zjson
 
 #endif  // ZJSON_H
\ No newline at end of file